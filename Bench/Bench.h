@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class Timer {
+public:
+	Timer() : start(std::chrono::high_resolution_clock::now()) {}
+
+	double Seconds() const {
+		return std::chrono::duration<double, std::chrono::seconds::period>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+private:
+	std::chrono::high_resolution_clock::time_point start;
+};
+
+//Cheap deterministic generator so runs are repeatable between builds
+inline uint32_t XorShift(uint32_t& state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+inline void PrintResult(const std::string& name, double value, const std::string& unit) {
+	std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(14) << std::fixed << std::setprecision(2) << value << " " << unit << std::endl;
+}
+
+//Whatever followed the benchmark's name on the command line
+extern std::vector<std::string> benchArgs;
+
+//Noise terrain without structures, shared by the benchmarks that need realistic chunks
+void GenerateBenchChunk(class Chunk& chunk, int chunkX, int chunkZ);
+//Hash of a chunk's blocks mixed with its position. Summed over chunks it doesn't depend on the order they're added in
+uint64_t ChunkChecksum(const class Chunk& chunk, int chunkX, int chunkZ);
+
+//False when a check in the benchmark failed (e.g. results that should match don't), main exits with a failure then
+bool RunStorageBench();
+bool RunRegionBench();
+bool RunChunkMapBench();
+bool RunSlabBench();
+bool RunGenerationBench();
+bool RunNoiseBench();
+bool RunLatticeBench();
+bool RunEditsBench();
+bool RunWorldGenBench();
+bool RunMeshingBench();
\ No newline at end of file
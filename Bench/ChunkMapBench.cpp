@@ -0,0 +1,77 @@
+#include "Bench.h"
+#include "Block/ChunkData.h"
+#include "Util/ChunkMap.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/hash.hpp"
+
+#include <unordered_map>
+
+constexpr int MAP_RADIUS = 14; //Render distance plus the chunks kept around it
+constexpr int MESHED_CHUNKS = 64;
+constexpr int MESHED_HEIGHT = 80;
+
+//The lookups ChunkMesh::Update makes through BlockAt: the block itself, then its six neighbors,
+//for every block of a chunk. Almost all of them hit the same chunk as the last lookup
+template<typename Map>
+static void Measure(const std::string& name, Map& map) {
+	std::vector<glm::ivec2> meshed;
+	uint32_t seed = 0x2545F491u;
+	for (int i = 0; i < MESHED_CHUNKS; i++) {
+		meshed.emplace_back(int(XorShift(seed) % (2 * MAP_RADIUS - 1)) - MAP_RADIUS + 1, int(XorShift(seed) % (2 * MAP_RADIUS - 1)) - MAP_RADIUS + 1);
+	}
+
+	const glm::ivec3 neighbors[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+	uint64_t sink = 0, lookups = 0;
+	Timer mesher;
+	for (const auto& chunk : meshed) {
+		for (int x = 0; x < CHUNK_SIZE; x++) {
+			for (int z = 0; z < CHUNK_SIZE; z++) {
+				for (int y = 0; y < MESHED_HEIGHT; y++) {
+					glm::ivec3 block{ x + chunk.x * CHUNK_SIZE, y, z + chunk.y * CHUNK_SIZE };
+					sink += map.find(chunk)->second;
+					for (const auto& normal : neighbors) {
+						glm::ivec3 side = block + normal;
+						glm::ivec2 sideChunk{ (side.x & ~(CHUNK_SIZE - 1)) / CHUNK_SIZE, (side.z & ~(CHUNK_SIZE - 1)) / CHUNK_SIZE };
+						sink += map.find(sideChunk)->second;
+					}
+					lookups += 7;
+				}
+			}
+		}
+	}
+	double mesherTime = mesher.Seconds();
+
+	//Scattered lookups, with nothing for a last chunk cache to catch
+	std::vector<glm::ivec2> scattered(lookups / 8);
+	for (auto& chunk : scattered) {
+		chunk = { int(XorShift(seed) % (2 * MAP_RADIUS + 1)) - MAP_RADIUS, int(XorShift(seed) % (2 * MAP_RADIUS + 1)) - MAP_RADIUS };
+	}
+
+	Timer random;
+	for (const auto& chunk : scattered) {
+		sink += map.find(chunk)->second;
+	}
+	double randomTime = random.Seconds();
+
+	PrintResult(name + " mesher pattern", mesherTime / lookups * 1e9, "ns/lookup");
+	PrintResult(name + " scattered", randomTime / scattered.size() * 1e9, "ns/lookup");
+	if (sink == 1) std::cout << std::endl; //Keep the lookups alive
+}
+
+bool RunChunkMapBench() {
+	std::unordered_map<glm::ivec2, uint32_t> unorderedMap;
+	ChunkMap<uint32_t> chunkMap;
+	for (int x = -MAP_RADIUS; x <= MAP_RADIUS; x++) {
+		for (int z = -MAP_RADIUS; z <= MAP_RADIUS; z++) {
+			uint32_t value = uint32_t(x * 31 + z);
+			unorderedMap[{ x, z }] = value;
+			chunkMap[{ x, z }] = value;
+		}
+	}
+
+	Measure("std::unordered_map", unorderedMap);
+	Measure("ChunkMap", chunkMap);
+	return true;
+}
\ No newline at end of file
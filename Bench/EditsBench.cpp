@@ -0,0 +1,118 @@
+#include "Bench.h"
+#include "Block/ChunkGenerator.h"
+#include "Block/ChunkEdits.h"
+#include "Block/Block.h"
+#include "Block/RegionFile.h"
+
+#include <filesystem>
+
+constexpr int EDITED_CHUNK_PERCENT = 10;
+constexpr int EDITS_PER_CHUNK = 64;
+
+//A region's worth of decorated chunks, a few of them edited by the "player", saved the old way (every chunk whole)
+//and as edits only, then loaded back by generating the chunks again and applying the edits
+bool RunEditsBench() {
+	constexpr int REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+	const int size = REGION_SIZE + 2;
+	ChunkGenerator generator(1234);
+
+	auto generate = [&](std::vector<std::shared_ptr<Chunk>>& chunks) {
+		std::vector<std::shared_ptr<const Chunk>> terrain(size * size);
+		for (int i = 0; i < size * size; i++) {
+			terrain[i] = generator.GenerateTerrain(glm::ivec2(i % size - 1, i / size - 1));
+		}
+
+		chunks.resize(REGION_CHUNKS);
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			int x = i % REGION_SIZE, z = i / REGION_SIZE;
+			TerrainNeighborhood neighborhood;
+			for (int n = 0; n < 9; n++) {
+				neighborhood[n] = terrain[(z + n / 3) * size + x + n % 3];
+			}
+			chunks[i] = generator.Decorate(glm::ivec2(x, z), neighborhood);
+		}
+	};
+
+	std::vector<std::shared_ptr<Chunk>> chunks;
+	generate(chunks);
+
+	uint32_t state = 0x2545F491;
+	std::vector<ChunkEdits> edits(REGION_CHUNKS);
+	size_t editedChunks = 0;
+	for (int i = 0; i < REGION_CHUNKS; i++) {
+		if (XorShift(state) % 100 >= EDITED_CHUNK_PERCENT) continue;
+		editedChunks++;
+		for (int edit = 0; edit < EDITS_PER_CHUNK; edit++) {
+			int x = XorShift(state) % CHUNK_SIZE, y = 60 + XorShift(state) % 40, z = XorShift(state) % CHUNK_SIZE;
+			BlockID block = BlockID(XorShift(state) % (blocks.size() + 1));
+			chunks[i]->Set(x, y, z, block);
+			edits[i].Set(x, y, z, block);
+		}
+	}
+
+	std::filesystem::path wholePath = std::filesystem::temp_directory_path() / "FreshCraftBenchWhole.region";
+	std::filesystem::path editsPath = std::filesystem::temp_directory_path() / "FreshCraftBenchEdits.region";
+	std::filesystem::remove(wholePath);
+	std::filesystem::remove(editsPath);
+
+	std::vector<uint8_t> data;
+	double wholeSeconds, editsSeconds;
+	{
+		RegionFile region(wholePath);
+		Timer write;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			data.clear();
+			chunks[i]->Serialize(data);
+			region.Write(i % REGION_SIZE, i / REGION_SIZE, data);
+		}
+		wholeSeconds = write.Seconds();
+	}
+	{
+		RegionFile region(editsPath);
+		Timer write;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			if (edits[i].Empty()) continue;
+			data.clear();
+			edits[i].Serialize(data);
+			region.Write(i % REGION_SIZE, i / REGION_SIZE, data);
+		}
+		editsSeconds = write.Seconds();
+	}
+
+	size_t wholeBytes = std::filesystem::file_size(wholePath), editsBytes = std::filesystem::file_size(editsPath);
+	PrintResult("Edited chunks", double(editedChunks), "");
+	PrintResult("Whole save", double(wholeBytes) / 1024.0, "KB");
+	PrintResult("Edits save", double(editsBytes) / 1024.0, "KB");
+	PrintResult("Whole save time", wholeSeconds * 1000.0, "ms");
+	PrintResult("Edits save time", editsSeconds * 1000.0, "ms");
+
+	//Loading edits means generating the whole region again, the price for the smaller saves
+	std::vector<std::shared_ptr<Chunk>> loaded;
+	Timer load;
+	generate(loaded);
+	{
+		RegionFile region(editsPath);
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			ChunkEdits chunkEdits;
+			if (region.Read(i % REGION_SIZE, i / REGION_SIZE, data) && chunkEdits.Deserialize(data.data(), data.size())) {
+				chunkEdits.Apply(*loaded[i]);
+			}
+		}
+	}
+	PrintResult("Regenerate and apply edits", REGION_CHUNKS / load.Seconds(), "chunks/s");
+
+	size_t mismatches = 0;
+	for (int i = 0; i < REGION_CHUNKS; i++) {
+		for (uint32_t block = 0; block < CHUNK_VOLUME; block++) {
+			if (loaded[i]->Get(block) != chunks[i]->Get(block)) {
+				mismatches++;
+				break;
+			}
+		}
+	}
+	PrintResult("Chunks that didn't come back the same", double(mismatches), "");
+
+	std::filesystem::remove(wholePath);
+	std::filesystem::remove(editsPath);
+	return mismatches == 0;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Bench.h"
+#include "Block/GenerationQueue.h"
+#include "Util/Random.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+constexpr int GENERATION_RADIUS = 10; //Chunks out from the center, about a render distance worth
+
+//Everything within the radius generated and decorated by the queue's workers, the way ChunkManager fills in the world
+//around the player: terrain one chunk further out first, then decoration once it's all there. Returns decorated chunks per second.
+//The checksum covers every decorated chunk and doesn't depend on the order they finished in
+static double GenerateArea(const ChunkGenerator& generator, unsigned threads, uint64_t& checksum) {
+	GenerationQueue queue(generator, threads);
+	queue.SetFocus(glm::vec2(0.f), std::numeric_limits<float>::infinity());
+
+	std::vector<glm::ivec2> terrainIDs;
+	for (int x = -GENERATION_RADIUS - 1; x <= GENERATION_RADIUS + 1; x++) {
+		for (int z = -GENERATION_RADIUS - 1; z <= GENERATION_RADIUS + 1; z++) {
+			terrainIDs.emplace_back(x, z);
+		}
+	}
+
+	std::vector<GeneratedChunk> finished;
+	auto collect = [&](size_t count) {
+		finished.clear();
+		while (finished.size() < count) {
+			if (queue.Collect(finished) == 0) {
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		}
+	};
+
+	Timer timer;
+	queue.RequestTerrain(terrainIDs);
+	collect(terrainIDs.size());
+
+	const int size = GENERATION_RADIUS * 2 + 3;
+	std::vector<std::shared_ptr<const Chunk>> terrain(size * size);
+	for (auto& chunk : finished) {
+		terrain[(chunk.chunkID.y + GENERATION_RADIUS + 1) * size + chunk.chunkID.x + GENERATION_RADIUS + 1] = std::move(chunk.chunk);
+	}
+
+	std::vector<std::pair<glm::ivec2, TerrainNeighborhood>> decorations;
+	for (int x = -GENERATION_RADIUS; x <= GENERATION_RADIUS; x++) {
+		for (int z = -GENERATION_RADIUS; z <= GENERATION_RADIUS; z++) {
+			TerrainNeighborhood neighborhood;
+			for (int i = 0; i < 9; i++) {
+				neighborhood[i] = terrain[(z + i / 3 + GENERATION_RADIUS) * size + x + i % 3 + GENERATION_RADIUS];
+			}
+			decorations.emplace_back(glm::ivec2(x, z), std::move(neighborhood));
+		}
+	}
+	queue.RequestDecoration(decorations);
+	collect(decorations.size());
+	double rate = decorations.size() / timer.Seconds();
+
+	checksum = 0;
+	for (const auto& chunk : finished) {
+		checksum += ChunkChecksum(*chunk.chunk, chunk.chunkID.x, chunk.chunkID.y);
+	}
+	return rate;
+}
+
+uint64_t ChunkChecksum(const Chunk& chunk, int chunkX, int chunkZ) {
+	std::vector<uint8_t> data;
+	chunk.Serialize(data);
+	uint64_t hash = 0xCBF29CE484222325ull; //FNV-1a
+	for (uint8_t byte : data) hash = (hash ^ byte) * 0x100000001B3ull;
+	return Random::Mix(hash ^ Random::Key(0, chunkX, chunkZ));
+}
+
+bool RunGenerationBench() {
+	ChunkGenerator generator(1234);
+	unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+	//The same world has to come out no matter how many threads made it, so the checksums all have to match
+	uint64_t singleChecksum, checksum;
+	double single = GenerateArea(generator, 1, singleChecksum);
+	PrintResult("1 thread", single, "chunks/s");
+	std::cout << "  Checksum: " << std::hex << singleChecksum << std::dec << std::endl;
+
+	std::vector<unsigned> threadCounts;
+	for (unsigned threads = 2; threads < cores; threads *= 2) threadCounts.push_back(threads);
+	//Always at least one run with more threads than the first, even on a single core
+	threadCounts.push_back(std::max(cores, 2u));
+
+	bool deterministic = true;
+	for (unsigned threads : threadCounts) {
+		double rate = GenerateArea(generator, threads, checksum);
+		PrintResult(std::to_string(threads) + " threads", rate, "chunks/s");
+		PrintResult(std::to_string(threads) + " threads speedup", rate / single, "x");
+		if (checksum != singleChecksum) {
+			deterministic = false;
+			std::cerr << "  Checksum with " << threads << " threads is " << std::hex << checksum << std::dec << ", generation isn't deterministic" << std::endl;
+		}
+	}
+	return deterministic;
+}
\ No newline at end of file
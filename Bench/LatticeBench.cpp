@@ -0,0 +1,85 @@
+#include "Bench.h"
+#include "Block/ChunkGenerator.h"
+
+#include <cmath>
+#include <fstream>
+
+constexpr int LATTICE_RADIUS = 8; //Chunks out from the center that are compared
+
+//Noise evaluations per chunk, counting an fBm octave as one
+static int NoiseEvaluations(const TerrainSampling& sampling) {
+	auto samples = [](int step) { return step == 1 ? CHUNK_SIZE * CHUNK_SIZE : (CHUNK_SIZE / step + 1) * (CHUNK_SIZE / step + 1); };
+	int heightSamples = samples(sampling.heightStep);
+	int detailSamples = sampling.detailStep == 1 ? heightSamples : samples(sampling.detailStep);
+	return detailSamples * 8 + heightSamples * 14 + samples(sampling.sandStep);
+}
+
+static void WritePgm(const std::string& path, int width, int height, const std::vector<uint8_t>& pixels) {
+	std::ofstream file(path, std::ios::binary);
+	file << "P5\n" << width << " " << height << "\n255\n";
+	file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+}
+
+//Heights and surface blocks of a square of chunks, one value per column
+static double Surface(const ChunkGenerator& generator, std::vector<int>& heights, std::vector<BlockID>& surface) {
+	const int width = (LATTICE_RADIUS * 2 + 1) * CHUNK_SIZE;
+	heights.assign(width * width, 0);
+	surface.assign(width * width, 0);
+
+	Timer timer;
+	for (int chunkX = -LATTICE_RADIUS; chunkX <= LATTICE_RADIUS; chunkX++) {
+		for (int chunkZ = -LATTICE_RADIUS; chunkZ <= LATTICE_RADIUS; chunkZ++) {
+			auto chunk = generator.GenerateTerrain(glm::ivec2(chunkX, chunkZ));
+			for (int x = 0; x < CHUNK_SIZE; x++) {
+				for (int z = 0; z < CHUNK_SIZE; z++) {
+					int pixel = ((chunkZ + LATTICE_RADIUS) * CHUNK_SIZE + z) * width + (chunkX + LATTICE_RADIUS) * CHUNK_SIZE + x;
+					heights[pixel] = int(chunk->Height(x, z)) - 1;
+					surface[pixel] = chunk->Get(x, heights[pixel], z);
+				}
+			}
+		}
+	}
+	return timer.Seconds();
+}
+
+//Visual diff of the exact terrain against the coarse lattice: heightmaps of both and their difference
+//are written to lattice_exact.pgm, lattice_coarse.pgm and lattice_diff.pgm (mid grey is no change)
+bool RunLatticeBench() {
+	const TerrainSampling coarse = TerrainSampling::Coarse();
+	std::vector<int> exactHeights, coarseHeights;
+	std::vector<BlockID> exactSurface, coarseSurface;
+	double exactSeconds = Surface(ChunkGenerator(0), exactHeights, exactSurface);
+	double coarseSeconds = Surface(ChunkGenerator(0, coarse), coarseHeights, coarseSurface);
+
+	const int width = (LATTICE_RADIUS * 2 + 1) * CHUNK_SIZE;
+	const double chunks = double((LATTICE_RADIUS * 2 + 1) * (LATTICE_RADIUS * 2 + 1));
+	std::vector<uint8_t> exactPixels(width * width), coarsePixels(width * width), diffPixels(width * width);
+	int maxDiff = 0;
+	double totalDiff = 0.0;
+	size_t changedHeights = 0, changedSurfaces = 0;
+	for (int i = 0; i < width * width; i++) {
+		int diff = coarseHeights[i] - exactHeights[i];
+		maxDiff = std::max(maxDiff, std::abs(diff));
+		totalDiff += std::abs(diff);
+		if (diff != 0) changedHeights++;
+		if (coarseSurface[i] != exactSurface[i]) changedSurfaces++;
+
+		exactPixels[i] = uint8_t(std::clamp(exactHeights[i], 0, 255));
+		coarsePixels[i] = uint8_t(std::clamp(coarseHeights[i], 0, 255));
+		diffPixels[i] = uint8_t(std::clamp(128 + diff * 32, 0, 255));
+	}
+
+	WritePgm("lattice_exact.pgm", width, width, exactPixels);
+	WritePgm("lattice_coarse.pgm", width, width, coarsePixels);
+	WritePgm("lattice_diff.pgm", width, width, diffPixels);
+
+	PrintResult("Exact noise evaluations", NoiseEvaluations(TerrainSampling{}), "per chunk");
+	PrintResult("Coarse noise evaluations", NoiseEvaluations(coarse), "per chunk");
+	PrintResult("Exact terrain", chunks / exactSeconds, "chunks/s");
+	PrintResult("Coarse terrain", chunks / coarseSeconds, "chunks/s");
+	PrintResult("Max height difference", maxDiff, "blocks");
+	PrintResult("Mean height difference", totalDiff / (width * width), "blocks");
+	PrintResult("Columns with a different height", 100.0 * changedHeights / (width * width), "%");
+	PrintResult("Columns with a different surface", 100.0 * changedSurfaces / (width * width), "%");
+	return true;
+}
\ No newline at end of file
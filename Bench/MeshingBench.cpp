@@ -0,0 +1,117 @@
+#include "Bench.h"
+#include "Block/ChunkGenerator.h"
+#include "Block/ChunkMesher.h"
+
+#include <algorithm>
+#include <string>
+
+constexpr int MESHING_SIZE = 16; //Chunks across that are meshed
+constexpr int MESHING_RUNS = 4;
+
+//Blocks covered by the faces of a mesh, the same for every way of meshing a chunk
+static uint64_t FaceArea(const ChunkGeometry& geometry) {
+	uint64_t area = 0;
+	for (const auto* vertices : { &geometry.vertices, &geometry.transparentVertices }) {
+		//A quad's corners are flat along the axis it faces, and span its width and height along the other two
+		for (size_t i = 0; i < vertices->size(); i += 4) {
+			glm::ivec3 low = (*vertices)[i].Corner(), high = low;
+			for (size_t j = i + 1; j < i + 4; j++) {
+				low = glm::min(low, (*vertices)[j].Corner());
+				high = glm::max(high, (*vertices)[j].Corner());
+			}
+			glm::ivec3 extent = high - low;
+			area += uint64_t(std::max(extent.x, 1)) * std::max(extent.y, 1) * std::max(extent.z, 1);
+		}
+	}
+	return area;
+}
+
+//Meshes a square of generated chunks one face per block and with greedy meshing: meshing [size] [seed]. Prints the time
+//per chunk to copy them out of their neighborhoods and to mesh them, the vertices and buffer size both ways, and
+//checks the faces cover the same blocks
+bool RunMeshingBench() {
+	int size = MESHING_SIZE;
+	uint64_t seed = 1234;
+	try {
+		if (benchArgs.size() > 0) size = std::stoi(benchArgs[0]);
+		if (benchArgs.size() > 1) seed = std::stoull(benchArgs[1]);
+	}
+	catch (const std::exception&) {
+		std::cerr << "  Expected meshing [size] [seed]" << std::endl;
+		return false;
+	}
+	if (size < 1) {
+		std::cerr << "  The size has to be at least 1" << std::endl;
+		return false;
+	}
+
+	//Meshing reads one chunk past the edge, and decorating those one more
+	ChunkGenerator generator(seed);
+	const int decoratedSize = size + 2, terrainSize = size + 4;
+	std::vector<std::shared_ptr<const Chunk>> terrain(terrainSize * terrainSize);
+	for (int i = 0; i < terrainSize * terrainSize; i++) {
+		terrain[i] = generator.GenerateTerrain(glm::ivec2(i % terrainSize - 2, i / terrainSize - 2));
+	}
+	std::vector<std::shared_ptr<const Chunk>> chunks(decoratedSize * decoratedSize);
+	for (int i = 0; i < decoratedSize * decoratedSize; i++) {
+		int x = i % decoratedSize, z = i / decoratedSize;
+		TerrainNeighborhood neighborhood;
+		for (int n = 0; n < 9; n++) {
+			neighborhood[n] = terrain[(z + n / 3) * terrainSize + x + n % 3];
+		}
+		chunks[i] = generator.Decorate(glm::ivec2(x - 1, z - 1), neighborhood);
+	}
+
+	std::vector<ChunkNeighborhood> neighborhoods;
+	for (int z = 0; z < size; z++) {
+		for (int x = 0; x < size; x++) {
+			std::array<std::shared_ptr<const Chunk>, 9> neighbors;
+			for (int n = 0; n < 9; n++) {
+				neighbors[n] = chunks[(z + n / 3) * decoratedSize + x + n % 3];
+			}
+			neighborhoods.emplace_back(glm::ivec2(x, z), neighbors);
+		}
+	}
+
+	std::cout << "  " << size << " x " << size << " chunks, seed " << seed << std::endl;
+	std::vector<PaddedChunk> padded(neighborhoods.size());
+	Timer copyTimer;
+	for (int run = 0; run < MESHING_RUNS; run++) {
+		for (size_t i = 0; i < neighborhoods.size(); i++) {
+			padded[i].Copy(neighborhoods[i]);
+		}
+	}
+	PrintResult("Padded copy time", copyTimer.Seconds() * 1000000.0 / (MESHING_RUNS * neighborhoods.size()), "us/chunk");
+
+	ChunkGeometry geometry;
+	size_t vertices[2] = {};
+	std::vector<uint64_t> areas[2];
+	for (int greedy = 0; greedy < 2; greedy++) {
+		Timer timer;
+		for (int run = 0; run < MESHING_RUNS; run++) {
+			for (const auto& chunk : padded) {
+				BuildChunkMesh(chunk, greedy, geometry);
+				if (run == 0) {
+					vertices[greedy] += geometry.vertices.size() + geometry.transparentVertices.size();
+					areas[greedy].push_back(FaceArea(geometry));
+				}
+			}
+		}
+		double seconds = timer.Seconds();
+
+		std::string mode = greedy ? "Greedy" : "Per face";
+		PrintResult(mode + " mesh time", seconds * 1000000.0 / (MESHING_RUNS * neighborhoods.size()), "us/chunk");
+		PrintResult(mode + " vertices", double(vertices[greedy]) / neighborhoods.size(), "per chunk");
+		PrintResult(mode + " buffer", double(vertices[greedy] * sizeof(ChunkVertex)) / neighborhoods.size() / 1024.0, "KB per chunk");
+	}
+	PrintResult("Vertices saved", 100.0 * (1.0 - double(vertices[1]) / vertices[0]), "%");
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < neighborhoods.size(); i++) {
+		if (areas[0][i] != areas[1][i]) mismatches++;
+	}
+	if (mismatches > 0) {
+		std::cerr << "  " << mismatches << " chunks have faces the greedy mesh doesn't cover" << std::endl;
+	}
+	return mismatches == 0;
+}
\ No newline at end of file
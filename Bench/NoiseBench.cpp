@@ -0,0 +1,51 @@
+#include "Bench.h"
+#include "Noise/Noise.h"
+
+#include <cstring>
+
+constexpr int NOISE_CHUNKS = 256;
+constexpr int CHUNK_COLUMNS = 16 * 16;
+
+//The terrain noise of a chunk's columns: 8 octaves of detail, 14 of height and the sand noise, like ChunkGenerator
+bool RunNoiseBench() {
+	const SimplexNoise height{ 0.006f, 10.f, 2.1f, 0.45f }, detail{ 1.f, 1.f, 1.8f, 0.6f }, sand{ 0.006f, 1.f, 2.f, 0.5f, 42 };
+	const size_t columns = size_t(NOISE_CHUNKS) * CHUNK_COLUMNS;
+	std::vector<float> xs(columns), zs(columns);
+	for (size_t i = 0; i < columns; i++) {
+		xs[i] = float(i % 16 + (i / CHUNK_COLUMNS) * 16);
+		zs[i] = float(i / 16 % 16);
+	}
+
+	std::vector<float> scalar(columns * 3);
+	Timer scalarTimer;
+	for (size_t i = 0; i < columns; i++) {
+		scalar[i * 3] = detail.fractal(8, xs[i], zs[i]);
+		scalar[i * 3 + 1] = height.fractal(14, xs[i], zs[i]);
+		scalar[i * 3 + 2] = sand.noise(xs[i], zs[i]);
+	}
+	double scalarSeconds = scalarTimer.Seconds();
+
+	std::vector<float> batch(columns * 3), values(CHUNK_COLUMNS);
+	Timer batchTimer;
+	for (size_t start = 0; start < columns; start += CHUNK_COLUMNS) {
+		detail.fractal(8, &xs[start], &zs[start], values.data(), CHUNK_COLUMNS);
+		for (int i = 0; i < CHUNK_COLUMNS; i++) batch[(start + i) * 3] = values[i];
+		height.fractal(14, &xs[start], &zs[start], values.data(), CHUNK_COLUMNS);
+		for (int i = 0; i < CHUNK_COLUMNS; i++) batch[(start + i) * 3 + 1] = values[i];
+		sand.noise(&xs[start], &zs[start], values.data(), CHUNK_COLUMNS);
+		for (int i = 0; i < CHUNK_COLUMNS; i++) batch[(start + i) * 3 + 2] = values[i];
+	}
+	double batchSeconds = batchTimer.Seconds();
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < scalar.size(); i++) {
+		if (std::memcmp(&scalar[i], &batch[i], sizeof(float)) != 0) mismatches++;
+	}
+
+	std::cout << "  Batch path: " << SimplexNoise::simdLevel() << std::endl;
+	PrintResult("Scalar", columns / scalarSeconds / 1000.0, "K columns/s");
+	PrintResult("Batch", columns / batchSeconds / 1000.0, "K columns/s");
+	PrintResult("Speedup", scalarSeconds / batchSeconds, "x");
+	PrintResult("Values not bit-identical", double(mismatches), "");
+	return mismatches == 0;
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "Bench.h"
+#include "Block/ChunkData.h"
+#include "Block/RegionFile.h"
+
+#include <filesystem>
+
+bool RunRegionBench() {
+	constexpr int REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+
+	std::vector<Chunk> chunks(REGION_CHUNKS);
+	for (int i = 0; i < REGION_CHUNKS; i++) {
+		GenerateBenchChunk(chunks[i], i % REGION_SIZE, i / REGION_SIZE);
+	}
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "FreshCraftBench.region";
+	std::filesystem::remove(path);
+
+	size_t rawBytes = 0;
+	std::vector<uint8_t> data;
+	{
+		RegionFile region(path);
+		Timer write;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			data.clear();
+			chunks[i].Serialize(data);
+			rawBytes += data.size();
+			region.Write(i % REGION_SIZE, i / REGION_SIZE, data);
+		}
+		PrintResult("write", REGION_CHUNKS / write.Seconds(), "chunks/s");
+	}
+
+	//Reopen so the offset table is read back from disk as well
+	int mismatches = 0;
+	auto check = [&](int i, const Chunk& chunk) {
+		for (uint32_t block = 0; block < CHUNK_VOLUME; block += 7) {
+			if (chunk.Get(block) != chunks[i].Get(block)) {
+				mismatches++;
+				return;
+			}
+		}
+	};
+
+	{
+		RegionFile region(path);
+		std::vector<Chunk> loaded(REGION_CHUNKS);
+		Timer read;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			if (!region.Read(i % REGION_SIZE, i / REGION_SIZE, data) || !loaded[i].Deserialize(data.data(), data.size())) {
+				mismatches++;
+			}
+		}
+		PrintResult("copied read", REGION_CHUNKS / read.Seconds(), "chunks/s");
+
+		for (int i = 0; i < REGION_CHUNKS; i++) check(i, loaded[i]);
+	}
+
+	{
+		RegionFile region(path);
+		std::vector<Chunk> loaded(REGION_CHUNKS);
+		Timer read;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			const uint8_t* mapped;
+			size_t size;
+			auto mapping = region.Map(i % REGION_SIZE, i / REGION_SIZE, mapped, size);
+			if (!mapping || !loaded[i].Deserialize(mapped, size, mapping)) {
+				mismatches++;
+			}
+		}
+		PrintResult("mapped read", REGION_CHUNKS / read.Seconds(), "chunks/s");
+
+		size_t borrowed = 0;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			check(i, loaded[i]);
+			for (int section = 0; section < SECTIONS_PER_CHUNK; section++) {
+				if (loaded[i].Section(section).IsBorrowed()) borrowed++;
+			}
+		}
+		PrintResult("sections read in place", double(borrowed) / REGION_CHUNKS, "per chunk");
+	}
+
+	size_t fileBytes = std::filesystem::file_size(path);
+
+	//Chunks that are still mapped when they're written again, like evicted chunks that were loaded from the file, are moved.
+	//The space they leave has to be reused, or the file grows for as long as the game runs
+	constexpr int REWRITES = 8;
+	{
+		RegionFile region(path);
+		for (int pass = 0; pass < REWRITES; pass++) {
+			std::vector<std::shared_ptr<const MappedFile>> mappings(REGION_CHUNKS);
+			for (int i = 0; i < REGION_CHUNKS; i++) {
+				const uint8_t* mapped;
+				size_t size;
+				mappings[i] = region.Map(i % REGION_SIZE, i / REGION_SIZE, mapped, size);
+			}
+			for (int i = 0; i < REGION_CHUNKS; i++) {
+				data.clear();
+				chunks[i].Serialize(data);
+				region.Write(i % REGION_SIZE, i / REGION_SIZE, data);
+			}
+		}
+
+		Chunk loaded;
+		for (int i = 0; i < REGION_CHUNKS; i++) {
+			if (!region.Read(i % REGION_SIZE, i / REGION_SIZE, data) || !loaded.Deserialize(data.data(), data.size())) {
+				mismatches++;
+			}
+			else {
+				check(i, loaded);
+			}
+		}
+	}
+	size_t rewrittenBytes = std::filesystem::file_size(path);
+	std::filesystem::remove(path);
+
+	PrintResult("serialized chunk", double(rawBytes) / REGION_CHUNKS / 1024.0, "KB");
+	PrintResult("region file per chunk", double(fileBytes) / REGION_CHUNKS / 1024.0, "KB");
+	PrintResult("region file after " + std::to_string(REWRITES) + " mapped rewrites", double(rewrittenBytes) / fileBytes, "x");
+	PrintResult("chunks that didn't round trip", mismatches, "");
+	//Each chunk has at most its old bytes, still mapped, and its new ones
+	return mismatches == 0 && rewrittenBytes <= 2 * fileBytes;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "Bench.h"
+#include "Block/ChunkData.h"
+#include "Util/SlabAllocator.h"
+
+#include <deque>
+#include <memory>
+
+constexpr int WINDOW_SIZE = 24; //Chunks kept loaded across, about what the game keeps around the player
+constexpr int WALK_STEPS = 256;
+
+//The player walking in a straight line: every step a row of chunks is loaded in front and one is dropped behind,
+//like ChunkManager faulting chunks back in from region files and evicting them again
+bool RunSlabBench() {
+	std::vector<std::vector<uint8_t>> saved(WINDOW_SIZE * 2);
+	for (size_t i = 0; i < saved.size(); i++) {
+		Chunk chunk;
+		GenerateBenchChunk(chunk, int(i % WINDOW_SIZE), int(i / WINDOW_SIZE));
+		chunk.Serialize(saved[i]);
+	}
+
+	//Earlier benchmarks leave their allocations in the totals, the footprint is measured from here
+	SlabAllocator::ResetPeak();
+	SlabStats before = SlabAllocator::Stats();
+
+	std::deque<std::unique_ptr<Chunk>> window;
+	Timer walk;
+	uint64_t loaded = 0;
+	for (int step = 0; step < WALK_STEPS + WINDOW_SIZE; step++) {
+		for (int z = 0; z < WINDOW_SIZE; z++) {
+			const auto& data = saved[(step * WINDOW_SIZE + z) % saved.size()];
+			auto& chunk = window.emplace_back(std::make_unique<Chunk>());
+			if (!chunk->Deserialize(data.data(), data.size())) {
+				std::cerr << "Saved chunk didn't deserialize" << std::endl;
+				return false;
+			}
+			loaded++;
+		}
+
+		if (window.size() > WINDOW_SIZE * WINDOW_SIZE) {
+			for (int z = 0; z < WINDOW_SIZE; z++) window.pop_front();
+		}
+	}
+	double walkTime = walk.Seconds();
+
+	SlabStats after = SlabAllocator::Stats();
+	uint64_t allocations = after.allocations - before.allocations;
+	uint64_t recycled = after.recycled - before.recycled;
+
+	PrintResult("chunk loads", loaded / walkTime, "chunks/s");
+	PrintResult("allocations", double(allocations), "");
+	PrintResult("hit rate", allocations > 0 ? 100.0 * recycled / allocations : 0.0, "%");
+	PrintResult("fallback allocations", double(after.fallbacks - before.fallbacks), "");
+	PrintResult("current footprint", (double(after.usedBytes) - double(before.usedBytes)) / 1024.0, "KB");
+	PrintResult("peak footprint", double(after.peakUsedBytes - before.usedBytes) / 1024.0, "KB");
+	PrintResult("reserved slab memory", double(after.reservedBytes) / 1024.0, "KB");
+	return true;
+}
\ No newline at end of file
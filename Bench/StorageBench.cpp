@@ -0,0 +1,96 @@
+#include "Bench.h"
+#include "Block/ChunkData.h"
+#include "Noise/Noise.h"
+
+#include <array>
+#include <memory>
+
+constexpr int BENCH_CHUNKS = 64;
+constexpr uint32_t RANDOM_READS = 1 << 24;
+
+using FlatChunk = std::array<BlockID, CHUNK_VOLUME>;
+
+//Same layering as ChunkManager::GenerateChunk, minus the structures
+static BlockID TerrainBlock(int y, int height, int sandNoise) {
+	if (y == height) return y > 66 + sandNoise ? 1 : 7;
+	if (y > height - 2 && y < height) return y > 66 + sandNoise ? 2 : 7;
+	if (y < height) return 3;
+	if (y < 64) return 4;
+	return 0;
+}
+
+template<typename Read>
+static void Measure(const std::string& name, Read&& read) {
+	uint32_t seed = 0x9E3779B9u;
+	std::vector<uint32_t> indices(RANDOM_READS);
+	for (auto& index : indices) index = XorShift(seed);
+
+	uint64_t sink = 0;
+	Timer random;
+	for (uint32_t i = 0; i < RANDOM_READS; i++) {
+		uint32_t index = indices[i];
+		sink += read(index % BENCH_CHUNKS, (index >> 6) % CHUNK_VOLUME);
+	}
+	double randomTime = random.Seconds();
+
+	Timer scan;
+	for (int chunk = 0; chunk < BENCH_CHUNKS; chunk++) {
+		for (uint32_t i = 0; i < CHUNK_VOLUME; i++) {
+			sink += read(chunk, i) > 0;
+		}
+	}
+	double scanTime = scan.Seconds();
+
+	PrintResult(name + " random reads", RANDOM_READS / randomTime / 1e6, "M/s");
+	PrintResult(name + " scan", double(BENCH_CHUNKS) * CHUNK_VOLUME / scanTime / 1e6, "M/s");
+	if (sink == 1) std::cout << std::endl; //Keep the reads alive
+}
+
+void GenerateBenchChunk(Chunk& chunk, int chunkX, int chunkZ) {
+	static const SimplexNoise height{ 0.006f, 10.f, 2.1f, 0.45f }, sand{ 0.006f, 1.f };
+
+	for (int x = 0; x < CHUNK_SIZE; x++) {
+		for (int z = 0; z < CHUNK_SIZE; z++) {
+			float worldX = float(x + chunkX * CHUNK_SIZE), worldZ = float(z + chunkZ * CHUNK_SIZE);
+			int columnHeight = int(height.fractal(14, worldX, worldZ) * 26.f + 70.f);
+			int sandNoise = int(sand.noise(worldX, worldZ) * 2.f);
+			for (int y = 0; y < MAX_BLOCK_HEIGHT; y++) {
+				BlockID block = TerrainBlock(y, columnHeight, sandNoise);
+				if (block == 0 && y >= 64) break;
+				chunk.Set(x, y, z, block);
+			}
+		}
+	}
+
+	chunk.Compact();
+}
+
+bool RunStorageBench() {
+	std::vector<std::unique_ptr<FlatChunk>> flat;
+	std::vector<Chunk> sectioned(BENCH_CHUNKS);
+	for (int chunk = 0; chunk < BENCH_CHUNKS; chunk++) {
+		GenerateBenchChunk(sectioned[chunk], chunk % 8, chunk / 8);
+
+		auto& flatChunk = flat.emplace_back(std::make_unique<FlatChunk>());
+		for (uint32_t i = 0; i < CHUNK_VOLUME; i++) {
+			(*flatChunk)[i] = sectioned[chunk].Get(i);
+		}
+	}
+
+	size_t sectionedBytes = 0;
+	int uniformSections = 0;
+	for (const auto& chunkData : sectioned) {
+		sectionedBytes += chunkData.MemoryUsage();
+		for (int section = 0; section < SECTIONS_PER_CHUNK; section++) {
+			if (chunkData.IsSectionUniform(section)) uniformSections++;
+		}
+	}
+	PrintResult("flat array memory", double(BENCH_CHUNKS * sizeof(FlatChunk)) / 1024.0, "KB");
+	PrintResult("sectioned memory", double(sectionedBytes) / 1024.0, "KB");
+	PrintResult("sectioned bits per block", double(sectionedBytes * 8) / (double(BENCH_CHUNKS) * CHUNK_VOLUME), "bits");
+	PrintResult("uniform sections", 100.0 * uniformSections / (BENCH_CHUNKS * SECTIONS_PER_CHUNK), "%");
+
+	Measure("flat array", [&flat](uint32_t chunk, uint32_t index) { return (*flat[chunk])[index]; });
+	Measure("sectioned", [&sectioned](uint32_t chunk, uint32_t index) { return sectioned[chunk].Get(index); });
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "Bench.h"
+#include "Block/ChunkGenerator.h"
+#include "Util/SlabAllocator.h"
+
+#include <string>
+
+constexpr int WORLDGEN_SIZE = 32; //Chunks across, a region
+constexpr uint64_t WORLDGEN_SEED = 1234;
+
+//An N x N square of chunks generated and decorated from a seed on this thread, so the stage times add up to the total:
+//worldgen [size] [seed] [coarse]. The checksum only changes when the generated blocks do, so a build machine without
+//a GPU can tell whether a change to generation made it faster, and whether it changed the world while at it
+bool RunWorldGenBench() {
+	int size = WORLDGEN_SIZE;
+	uint64_t seed = WORLDGEN_SEED;
+	TerrainSampling sampling;
+	try {
+		if (benchArgs.size() > 0) size = std::stoi(benchArgs[0]);
+		if (benchArgs.size() > 1) seed = std::stoull(benchArgs[1]);
+	}
+	catch (const std::exception&) {
+		std::cerr << "  Expected worldgen [size] [seed] [coarse]" << std::endl;
+		return false;
+	}
+	if (benchArgs.size() > 2 && benchArgs[2] == "coarse") sampling = TerrainSampling::Coarse();
+	if (size < 1) {
+		std::cerr << "  The size has to be at least 1" << std::endl;
+		return false;
+	}
+
+	ChunkGenerator generator(seed, sampling);
+	SlabStats before = SlabAllocator::Stats();
+	GenerationTimings timings;
+
+	//Decoration needs the terrain one chunk further out
+	const int terrainSize = size + 2;
+	Timer timer;
+	std::vector<std::shared_ptr<const Chunk>> terrain(terrainSize * terrainSize);
+	for (int i = 0; i < terrainSize * terrainSize; i++) {
+		terrain[i] = generator.GenerateTerrain(glm::ivec2(i % terrainSize - 1, i / terrainSize - 1), &timings);
+	}
+
+	std::vector<std::shared_ptr<Chunk>> chunks(size * size);
+	for (int i = 0; i < size * size; i++) {
+		int x = i % size, z = i / size;
+		TerrainNeighborhood neighborhood;
+		for (int n = 0; n < 9; n++) {
+			neighborhood[n] = terrain[(z + n / 3) * terrainSize + x + n % 3];
+		}
+		chunks[i] = generator.Decorate(glm::ivec2(x, z), neighborhood, &timings);
+	}
+	double seconds = timer.Seconds();
+
+	size_t terrainBytes = 0, chunkBytes = 0;
+	for (const auto& chunk : terrain) terrainBytes += chunk->MemoryUsage();
+	uint64_t checksum = 0;
+	for (int i = 0; i < size * size; i++) {
+		chunkBytes += chunks[i]->MemoryUsage();
+		checksum += ChunkChecksum(*chunks[i], i % size, i / size);
+	}
+	SlabStats after = SlabAllocator::Stats();
+
+	//Share of the columns in each biome
+	size_t biomeColumns[BIOME_COUNT] = {};
+	for (int i = 0; i < size * size; i++) {
+		glm::ivec2 chunkID(i % size, i / size);
+		auto region = generator.Biomes().Region(BiomeMap::RegionOf(chunkID));
+		glm::ivec2 offset = BiomeMap::OffsetInRegion(chunkID);
+		for (int z = 0; z < CHUNK_SIZE; z++) {
+			for (int x = 0; x < CHUNK_SIZE; x++) {
+				biomeColumns[(int)region->At(offset.x + x, offset.y + z)]++;
+			}
+		}
+	}
+
+	std::cout << "  " << size << " x " << size << " chunks, seed " << seed << (sampling.heightStep == 1 ? "" : ", coarse sampling") << std::endl;
+	PrintResult("Chunks", size * size / seconds, "chunks/s");
+	PrintResult("Noise", timings.noise * 1000.0, "ms");
+	PrintResult("Fill", timings.fill * 1000.0, "ms");
+	PrintResult("Decoration", timings.decoration * 1000.0, "ms");
+	PrintResult("Total", seconds * 1000.0, "ms");
+	PrintResult("Decorated chunks", chunkBytes / 1024.0, "KB");
+	PrintResult("Terrain", terrainBytes / 1024.0, "KB");
+	PrintResult("Per chunk", double(chunkBytes) / (size * size), "bytes");
+	PrintResult("Block slabs reserved", double(after.reservedBytes - before.reservedBytes) / 1024.0, "KB");
+	for (int i = 0; i < BIOME_COUNT; i++) {
+		PrintResult(GetBiomeInfo((Biome)i).name, 100.0 * biomeColumns[i] / (size * size * CHUNK_SIZE * CHUNK_SIZE), "%");
+	}
+	std::cout << "  Checksum: " << std::hex << checksum << std::dec << std::endl;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <cstdlib>
+
+std::vector<std::string> benchArgs;
+
+int main(int argc, char* argv[]) {
+	const std::map<std::string, std::function<bool()>> benches = {
+		{ "storage", RunStorageBench },
+		{ "region", RunRegionBench },
+		{ "chunkmap", RunChunkMapBench },
+		{ "slab", RunSlabBench },
+		{ "generation", RunGenerationBench },
+		{ "noise", RunNoiseBench },
+		{ "lattice", RunLatticeBench },
+		{ "edits", RunEditsBench },
+		{ "worldgen", RunWorldGenBench },
+		{ "meshing", RunMeshingBench }
+	};
+
+	std::string name = argc > 1 ? argv[1] : "all";
+	benchArgs.assign(argv + std::min(argc, 2), argv + argc);
+	if (name != "all" && !benches.contains(name)) {
+		std::cerr << "Unknown benchmark '" << name << "', expected one of: all";
+		for (const auto& kv : benches) std::cerr << ", " << kv.first;
+		std::cerr << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::string> failed;
+	for (const auto& kv : benches) {
+		if (name == "all" || name == kv.first) {
+			std::cout << kv.first << ":" << std::endl;
+			if (!kv.second()) failed.push_back(kv.first);
+		}
+	}
+
+	if (!failed.empty()) {
+		std::cerr << "Failed:";
+		for (const auto& bench : failed) std::cerr << " " << bench;
+		std::cerr << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
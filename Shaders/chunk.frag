@@ -5,9 +5,12 @@ layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec2 inUV;
 layout(location = 4) in vec4 inLightSpacePos;
+layout(location = 5) flat in vec2 inTile;
 
 layout(location = 0) out vec4 outColor;
 
+#define TEXTURE_ATLAS_SIZE 8.0
+
 layout(set = 1, binding = 0) uniform sampler2D textureAtlas;
 
 layout(set = 2, binding = 0) uniform sampler2D shadowMap;
@@ -62,7 +65,8 @@ float Shadow(vec4 lightSpacePos) {
 
 void main() {
 	//outColor = vec4(color, 1.0);
-	outColor = texture(textureAtlas, inUV);
+	//The uv counts blocks across the face, so merged faces repeat the tile once per block
+	outColor = texture(textureAtlas, inTile + fract(inUV) / TEXTURE_ATLAS_SIZE);
 	outColor.xyz *= inColor;
 
 	if (outColor.a < 0.01)
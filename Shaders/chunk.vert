@@ -1,15 +1,14 @@
 #version 450
 
-layout(location = 0) in vec3 pos;
-layout(location = 1) in vec3 normal;
-layout(location = 2) in vec3 color;
-layout(location = 3) in vec2 uv;
+//A packed ChunkVertex, see ChunkMesher.h
+layout(location = 0) in uint data;
 
 layout(location = 0) out vec3 outPos;
 layout(location = 1) out vec3 outColor;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec2 outUv;
 layout(location = 4) out vec4 outLightSpacePos;
+layout(location = 5) flat out vec2 outTile;
 
 layout(set = 0, binding = 0) uniform GlobalUBO {
 	mat4 view;
@@ -29,12 +28,46 @@ layout(push_constant) uniform ChunkPushConstants {
 	ivec2 pos;
 } push;
 
+#define TEXTURE_ATLAS_SIZE 8u
+#define LOWERED (1u << 22)
+#define INSET (1u << 23)
+
+//Top, bottom, right, left, front, back
+const vec3 normals[6] = vec3[](
+	vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+	vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+	vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0)
+);
+const float shades[6] = float[](1.0, 0.7, 0.9, 0.85, 0.7, 0.75);
+//The uv of a corner is its position along these, so the tile repeats once per block the way up it was on single blocks
+const vec3 uAxes[6] = vec3[](
+	vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+	vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0),
+	vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0)
+);
+const vec3 vAxes[6] = vec3[](
+	vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, -1.0),
+	vec3(0.0, -1.0, 0.0), vec3(0.0, -1.0, 0.0),
+	vec3(0.0, -1.0, 0.0), vec3(0.0, -1.0, 0.0)
+);
+
 void main() {
+	vec3 corner = vec3(data & 31u, (data >> 5) & 511u, (data >> 14) & 31u);
+	uint side = (data >> 19) & 7u;
+	uint tile = (data >> 24) & 255u;
+
+	vec3 pos = corner;
+	if ((data & LOWERED) != 0u)
+		pos.y -= 0.0625;
+	if ((data & INSET) != 0u)
+		pos -= normals[side] * 0.001;
+
 	//TODO: specialization constants
 	outPos = pos + vec3(push.pos.x - 0.5, 0.0, push.pos.y - 0.5) * 16.0;
 	gl_Position = ubo.proj * ubo.view * vec4(outPos, 1.0);
-	outUv = uv;
-	outColor = color;
-	outNormal = normal;
+	outUv = vec2(dot(corner, uAxes[side]), dot(corner, vAxes[side]));
+	outTile = vec2(tile % TEXTURE_ATLAS_SIZE, tile / TEXTURE_ATLAS_SIZE) / float(TEXTURE_ATLAS_SIZE);
+	outColor = vec3(shades[side]);
+	outNormal = normals[side];
 	outLightSpacePos = shadowUBO.lightTransform * vec4(outPos, 1.0);
 }
\ No newline at end of file
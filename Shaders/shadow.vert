@@ -1,9 +1,7 @@
 #version 450
 
-layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec2 inUV;
+//A packed ChunkVertex, see ChunkMesher.h and chunk.vert
+layout(location = 0) in uint data;
 
 layout(set = 0, binding = 0) uniform ShadowUBO {
 	mat4 lightTransform;
@@ -13,6 +11,11 @@ layout(push_constant) uniform ChunkPush {
 	ivec2 chunkPos;
 } push;
 
+#define LOWERED (1u << 22)
+
 void main() {
+	vec3 inPos = vec3(data & 31u, (data >> 5) & 511u, (data >> 14) & 31u);
+	if ((data & LOWERED) != 0u)
+		inPos.y -= 0.0625;
 	gl_Position = ubo.lightTransform * vec4(inPos + vec3(push.chunkPos.x - 0.5, 0.0, push.chunkPos.y - 0.5) * 16.0, 1.0);
 }
\ No newline at end of file
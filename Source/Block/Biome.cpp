@@ -0,0 +1,114 @@
+#include "Biome.h"
+
+//Regions kept around, well over what the generation workers are in the middle of at once
+constexpr size_t MAX_CACHED_REGIONS = 64;
+constexpr size_t CLIMATE_OCTAVES = 4;
+
+static const std::array<BiomeInfo, BIOME_COUNT> biomeInfos = { {
+	{ "Plains", 1, 2, 26.f, 70.f, MAX_BLOCK_HEIGHT, 0.008f }, //Grass, dirt
+	{ "Forest", 1, 2, 30.f, 72.f, MAX_BLOCK_HEIGHT, 0.04f },
+	{ "Desert", 7, 7, 12.f, 68.f, MAX_BLOCK_HEIGHT, 0.f }, //Sand
+	{ "Mountains", 1, 2, 60.f, 80.f, 105, 0.004f }
+} };
+
+const BiomeInfo& GetBiomeInfo(Biome biome) {
+	return biomeInfos[int(biome)];
+}
+
+static int FloorDiv(int value, int divisor) {
+	return value / divisor - (value % divisor != 0 && value < 0);
+}
+
+//How much each biome counts for at a climate, adding up to 1. They fade into each other over a band of the climate,
+//so the height parameters change smoothly across their borders
+static std::array<float, BIOME_COUNT> BiomeWeights(float temperature, float humidity) {
+	std::array<float, BIOME_COUNT> weights{};
+	weights[int(Biome::Mountains)] = 1.f - glm::smoothstep(-0.45f, -0.25f, temperature);
+	weights[int(Biome::Desert)] = glm::smoothstep(0.2f, 0.4f, temperature) * (1.f - glm::smoothstep(-0.1f, 0.1f, humidity));
+	weights[int(Biome::Forest)] = glm::smoothstep(0.2f, 0.4f, humidity) * (1.f - weights[int(Biome::Mountains)]);
+	weights[int(Biome::Plains)] = 1.f - weights[int(Biome::Mountains)] - weights[int(Biome::Desert)] - weights[int(Biome::Forest)];
+	return weights;
+}
+
+void BiomeRegion::HeightParams(int x, int z, float& scale, float& offset) const {
+	int cellX = x / BIOME_CELL_SIZE, cellZ = z / BIOME_CELL_SIZE;
+	float tx = float(x % BIOME_CELL_SIZE) / BIOME_CELL_SIZE, tz = float(z % BIOME_CELL_SIZE) / BIOME_CELL_SIZE;
+	int corner = cellZ * BIOME_REGION_CORNERS + cellX;
+
+	auto sample = [&](const std::array<float, BIOME_REGION_CORNERS * BIOME_REGION_CORNERS>& values) {
+		float top = values[corner] + (values[corner + 1] - values[corner]) * tx;
+		float bottom = values[corner + BIOME_REGION_CORNERS] + (values[corner + BIOME_REGION_CORNERS + 1] - values[corner + BIOME_REGION_CORNERS]) * tx;
+		return top + (bottom - top) * tz;
+	};
+	scale = sample(heightScales);
+	offset = sample(heightOffsets);
+}
+
+BiomeMap::BiomeMap(uint64_t temperatureSeed, uint64_t humiditySeed)
+	: temperature(0.0015f, 1.f, 2.f, 0.5f, temperatureSeed), humidity(0.0015f, 1.f, 2.f, 0.5f, humiditySeed) {
+
+}
+
+std::shared_ptr<const BiomeRegion> BiomeMap::Region(const glm::ivec2& regionID) const {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto region = regions.find(regionID);
+		if (region != regions.end()) return region->second;
+	}
+
+	//Two threads may both compute a missing region, they get the same result so either one can be kept
+	std::shared_ptr<const BiomeRegion> computed = Compute(regionID);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto region = regions.find(regionID);
+	if (region != regions.end()) return region->second;
+
+	regions[regionID] = computed;
+	order.push_back(regionID);
+	if (order.size() > MAX_CACHED_REGIONS) {
+		regions.erase(order.front());
+		order.pop_front();
+	}
+	return computed;
+}
+
+glm::ivec2 BiomeMap::RegionOf(const glm::ivec2& chunkID) {
+	return glm::ivec2(FloorDiv(chunkID.x, BIOME_REGION_SIZE), FloorDiv(chunkID.y, BIOME_REGION_SIZE));
+}
+
+glm::ivec2 BiomeMap::OffsetInRegion(const glm::ivec2& chunkID) {
+	return (chunkID - RegionOf(chunkID) * BIOME_REGION_SIZE) * CHUNK_SIZE;
+}
+
+std::shared_ptr<const BiomeRegion> BiomeMap::Compute(const glm::ivec2& regionID) const {
+	constexpr int CORNERS = BIOME_REGION_CORNERS * BIOME_REGION_CORNERS;
+	std::array<float, CORNERS> xs, zs, temperatures, humidities;
+	glm::ivec2 origin = regionID * BIOME_REGION_SIZE * CHUNK_SIZE;
+	for (int i = 0; i < CORNERS; i++) {
+		xs[i] = float(origin.x + i % BIOME_REGION_CORNERS * BIOME_CELL_SIZE);
+		zs[i] = float(origin.y + i / BIOME_REGION_CORNERS * BIOME_CELL_SIZE);
+	}
+	temperature.fractal(CLIMATE_OCTAVES, xs.data(), zs.data(), temperatures.data(), CORNERS);
+	humidity.fractal(CLIMATE_OCTAVES, xs.data(), zs.data(), humidities.data(), CORNERS);
+
+	auto region = std::make_shared<BiomeRegion>();
+	for (int i = 0; i < CORNERS; i++) {
+		std::array<float, BIOME_COUNT> weights = BiomeWeights(temperatures[i], humidities[i]);
+		float scale = 0.f, offset = 0.f;
+		int strongest = 0;
+		for (int biome = 0; biome < BIOME_COUNT; biome++) {
+			scale += weights[biome] * biomeInfos[biome].heightScale;
+			offset += weights[biome] * biomeInfos[biome].heightOffset;
+			if (weights[biome] > weights[strongest]) strongest = biome;
+		}
+		region->heightScales[i] = scale;
+		region->heightOffsets[i] = offset;
+
+		//A cell takes the biome of its corner nearest the region's origin
+		int x = i % BIOME_REGION_CORNERS, z = i / BIOME_REGION_CORNERS;
+		if (x < BIOME_REGION_CELLS && z < BIOME_REGION_CELLS) {
+			region->biomes[z * BIOME_REGION_CELLS + x] = Biome(strongest);
+		}
+	}
+	return region;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ChunkData.h"
+#include "Noise/Noise.h"
+#include "Util/ChunkMap.h"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+constexpr int BIOME_CELL_SIZE = 4; //Blocks across a biome cell, every column in a cell has the same biome
+constexpr int BIOME_REGION_SIZE = 4; //Chunks across a cached region of biomes
+constexpr int BIOME_REGION_CELLS = BIOME_REGION_SIZE * CHUNK_SIZE / BIOME_CELL_SIZE;
+constexpr int BIOME_REGION_CORNERS = BIOME_REGION_CELLS + 1;
+
+enum class Biome : uint8_t {
+	Plains,
+	Forest,
+	Desert,
+	Mountains
+};
+constexpr int BIOME_COUNT = 4;
+
+//What a biome changes about generation
+struct BiomeInfo {
+	const char* name;
+	BlockID surface, subsurface;
+	//The terrain is the height noise times the scale plus the offset. Blended between biomes, so their borders don't turn into cliffs
+	float heightScale, heightOffset;
+	//Columns taller than this are bare stone
+	int bareAbove;
+	//Chance of a tree being rooted in a column
+	float treeChance;
+};
+
+const BiomeInfo& GetBiomeInfo(Biome biome);
+
+//The biomes of a BIOME_REGION_SIZE x BIOME_REGION_SIZE square of chunks, one per cell, and the blended height parameters
+//at the corners of the cells. The corners take in the first row and column of the next region, so every column can be
+//interpolated from the region it's in, and neighboring regions meet without a seam
+struct BiomeRegion {
+	std::array<Biome, BIOME_REGION_CELLS * BIOME_REGION_CELLS> biomes;
+	std::array<float, BIOME_REGION_CORNERS * BIOME_REGION_CORNERS> heightScales, heightOffsets;
+
+	//x and z are in blocks from the region's corner
+	Biome At(int x, int z) const { return biomes[z / BIOME_CELL_SIZE * BIOME_REGION_CELLS + x / BIOME_CELL_SIZE]; }
+	//The height parameters of the column, interpolated between the corners of its cell
+	void HeightParams(int x, int z, float& scale, float& offset) const;
+};
+
+//Biomes come from two slow climate noise layers, temperature and humidity, evaluated once per cell corner. The regions
+//are cached, so the chunks of a region and both generation stages share one evaluation. The cache only keeps the most
+//recently computed regions, but a region can always be computed again and comes out the same
+class BiomeMap {
+public:
+	BiomeMap(uint64_t temperatureSeed, uint64_t humiditySeed);
+
+	//Computed the first time it's needed. Any number of threads can call it at once
+	std::shared_ptr<const BiomeRegion> Region(const glm::ivec2& regionID) const;
+	//The region a chunk is in
+	static glm::ivec2 RegionOf(const glm::ivec2& chunkID);
+	//The chunk's columns in its region start here
+	static glm::ivec2 OffsetInRegion(const glm::ivec2& chunkID);
+
+private:
+	std::shared_ptr<const BiomeRegion> Compute(const glm::ivec2& regionID) const;
+
+	SimplexNoise temperature, humidity;
+	mutable std::mutex mutex;
+	mutable ChunkMap<std::shared_ptr<const BiomeRegion>> regions;
+	//Oldest first
+	mutable std::deque<glm::ivec2> order;
+};
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
-#include "Common.h"
+#include "glm/glm.hpp"
+
+#include <string>
+#include <vector>
 #undef TRANSPARENT
 
 struct Block {
@@ -11,4 +14,12 @@ struct Block {
 		TRANSPARENT = 1 << 1,
 		LIQUID = 1 << 2
 	} flags;
-};
\ No newline at end of file
+};
+
+//Indexed by BlockID - 1, air has no entry
+extern const std::vector<Block> blocks;
+
+//Whether a block ID read from disk is air or one of blocks, IDs past the end would index outside of blocks
+inline bool IsBlockID(unsigned id) {
+	return id <= blocks.size();
+}
\ No newline at end of file
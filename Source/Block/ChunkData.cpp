@@ -0,0 +1,395 @@
+#include "ChunkData.h"
+#include "Block.h"
+
+#include <cstring>
+#include <algorithm>
+
+//Zero bytes needed after offset to get back to 8 byte alignment
+static size_t Padding(size_t offset) {
+	return (sizeof(uint64_t) - offset % sizeof(uint64_t)) % sizeof(uint64_t);
+}
+
+//Histogram of the packed indices, a word at a time. Inside of terrain most words are one index repeated,
+//those are counted in one go instead of bumping the same counter over and over
+static void CountWords(const uint64_t* words, uint32_t size, uint32_t bits, uint32_t shift, std::array<uint32_t, 256>& counts) {
+	uint64_t mask = (1ull << bits) - 1ull;
+	uint64_t repeat = ~0ull / mask; //A 1 in the lowest bit of every index
+	uint32_t perWord = 1u << shift;
+	for (uint32_t first = 0; first < size; first += perWord) {
+		uint64_t word = words[first >> shift];
+		uint32_t count = std::min(perWord, size - first);
+		if (word == (word & mask) * repeat) {
+			counts[word & mask] += count;
+			continue;
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			counts[(word >> (i * bits)) & mask]++;
+		}
+	}
+}
+
+BlockStorage::BlockStorage(uint32_t size, BlockID fill) : size(size), uniform(fill) {
+
+}
+
+BlockStorage::BlockStorage(const BlockStorage& other) {
+	*this = other;
+}
+
+BlockStorage& BlockStorage::operator=(const BlockStorage& other) {
+	palette = other.palette;
+	data = other.data;
+	owner = other.owner;
+	words = owner ? other.words : data.data();
+	size = other.size;
+	bits = other.bits;
+	shift = other.shift;
+	mask = other.mask;
+	uniform = other.uniform;
+	return *this;
+}
+
+size_t BlockStorage::MemoryUsage() const {
+	return sizeof(BlockStorage) + palette.capacity() * sizeof(BlockID) + data.capacity() * sizeof(uint64_t);
+}
+
+BlockID BlockStorage::Set(uint32_t index, BlockID block) {
+	BlockID old = Get(index);
+	if (old == block) return old;
+
+	Own();
+	uint64_t paletteIndex = PaletteIndex(block);
+	uint64_t& word = data[index >> shift];
+	uint32_t offset = (index & ((1u << shift) - 1u)) * bits;
+	word = (word & ~(mask << offset)) | (paletteIndex << offset);
+	return old;
+}
+
+void BlockStorage::Fill(BlockID block) {
+	palette.clear();
+	palette.shrink_to_fit();
+	data.clear();
+	data.shrink_to_fit();
+	words = nullptr;
+	owner.reset();
+	bits = shift = 0;
+	mask = 0;
+	uniform = block;
+}
+
+void BlockStorage::Compact() {
+	if (bits == 0) return;
+
+	std::array<uint32_t, 256> counts{};
+	CountIndices(counts);
+
+	std::vector<BlockID> used;
+	std::array<uint32_t, 256> remap{};
+	for (uint32_t i = 0; i < palette.size(); i++) {
+		if (counts[i] > 0) {
+			remap[i] = uint32_t(used.size());
+			used.push_back(palette[i]);
+		}
+	}
+
+	if (used.size() == 1) {
+		Fill(used[0]);
+		return;
+	}
+	if (used.size() == palette.size()) return;
+
+	//Rewrite the indices in place, then shrink to the smallest width that fits
+	uint32_t newBits = 1;
+	while ((1ull << newBits) < used.size()) newBits *= 2;
+	Own();
+	for (uint32_t i = 0; i < size; i++) {
+		uint64_t& word = data[i >> shift];
+		uint32_t offset = (i & ((1u << shift) - 1u)) * bits;
+		word = (word & ~(mask << offset)) | (uint64_t(remap[IndexAt(i)]) << offset);
+	}
+
+	palette = std::move(used);
+	if (newBits != bits) Resize(newBits);
+}
+
+void BlockStorage::CountIndices(std::array<uint32_t, 256>& counts) const {
+	CountWords(words, size, bits, shift, counts);
+}
+
+void BlockStorage::Serialize(std::vector<uint8_t>& out, size_t start) const {
+	out.push_back(uint8_t(bits));
+	if (bits == 0) {
+		out.push_back(uniform);
+		return;
+	}
+
+	out.push_back(uint8_t(palette.size() - 1));
+	out.insert(out.end(), palette.begin(), palette.end());
+	out.resize(out.size() + Padding(out.size() - start), 0);
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+	out.insert(out.end(), bytes, bytes + WordCount() * sizeof(uint64_t));
+}
+
+bool BlockStorage::Deserialize(const uint8_t*& in, const uint8_t* start, const uint8_t* end, const std::shared_ptr<const void>& newOwner) {
+	if (end - in < 2) return false;
+	uint32_t newBits = in[0];
+	if (newBits == 0) {
+		if (!IsBlockID(in[1])) return false;
+		Fill(in[1]);
+		in += 2;
+		return true;
+	}
+	if (newBits != 1 && newBits != 2 && newBits != 4 && newBits != 8) return false;
+
+	size_t paletteSize = size_t(in[1]) + 1;
+	if (paletteSize > (1ull << newBits)) return false;
+
+	uint32_t newShift = 0;
+	while ((64u >> newShift) > newBits) newShift++;
+	size_t wordCount = ((size_t)size + (1ull << newShift) - 1) >> newShift;
+	size_t offset = 2 + paletteSize;
+	offset += Padding(size_t(in - start) + offset);
+	if (size_t(end - in) < offset + wordCount * sizeof(uint64_t)) return false;
+
+	//Borrowing needs the words to really be aligned in memory, not just in the stream
+	const uint8_t* source = in + offset;
+	bool borrow = newOwner && reinterpret_cast<uintptr_t>(source) % alignof(uint64_t) == 0;
+	BlockWords newData;
+	const uint64_t* newWords = reinterpret_cast<const uint64_t*>(source);
+	if (!borrow) {
+		newData.resize(wordCount);
+		std::memcpy(newData.data(), source, wordCount * sizeof(uint64_t));
+		newWords = newData.data();
+	}
+
+	//Every index has to land inside of the palette, or Get would read past it. Always true if the palette is full
+	if (paletteSize < (1ull << newBits)) {
+		std::array<uint32_t, 256> counts{};
+		CountWords(newWords, size, newBits, newShift, counts);
+		for (size_t i = paletteSize; i < (1ull << newBits); i++) {
+			if (counts[i] > 0) return false;
+		}
+	}
+
+	if (!std::all_of(in + 2, in + 2 + paletteSize, IsBlockID)) return false;
+
+	palette.assign(in + 2, in + 2 + paletteSize);
+	data = std::move(newData);
+	words = borrow ? newWords : data.data();
+	owner = borrow ? newOwner : nullptr;
+	bits = newBits;
+	shift = newShift;
+	mask = (1ull << newBits) - 1ull;
+	in += offset + wordCount * sizeof(uint64_t);
+	return true;
+}
+
+uint32_t BlockStorage::PaletteIndex(BlockID block) {
+	if (bits == 0) {
+		//Going from a uniform volume to a paletted one, the old block becomes index 0
+		palette.push_back(uniform);
+	}
+
+	for (uint32_t i = 0; i < palette.size(); i++) {
+		if (palette[i] == block) return i;
+	}
+
+	palette.push_back(block);
+	if (palette.size() > (1ull << bits)) {
+		uint32_t newBits = bits == 0 ? 1 : bits * 2;
+		Resize(newBits);
+	}
+
+	return uint32_t(palette.size() - 1);
+}
+
+void BlockStorage::Resize(uint32_t newBits) {
+	uint32_t newShift = 0;
+	while ((64u >> newShift) > newBits) newShift++;
+	uint64_t newMask = (1ull << newBits) - 1ull;
+
+	BlockWords newData(((size_t)size + (1ull << newShift) - 1) >> newShift, 0ull);
+	if (bits > 0) {
+		for (uint32_t i = 0; i < size; i++) {
+			newData[i >> newShift] |= uint64_t(IndexAt(i)) << ((i & ((1u << newShift) - 1u)) * newBits);
+		}
+	}
+
+	data = std::move(newData);
+	words = data.data();
+	owner.reset();
+	bits = newBits;
+	shift = newShift;
+	mask = newMask;
+}
+
+void BlockStorage::Own() {
+	if (!owner) return;
+
+	data.assign(words, words + WordCount());
+	words = data.data();
+	owner.reset();
+}
+
+void Chunk::Set(uint32_t index, BlockID block) {
+	BlockID old = sections[index / SECTION_VOLUME].Set(index % SECTION_VOLUME, block);
+	if (old == block) return;
+
+	AddBlocks(old, -1);
+	AddBlocks(block, 1);
+
+	int column = index % (CHUNK_SIZE * CHUNK_SIZE);
+	uint32_t top = index / (CHUNK_SIZE * CHUNK_SIZE) + 1;
+	if (block != 0 && top > heightmap[column]) {
+		heightmap[column] = uint16_t(top);
+		maxHeight = std::max(maxHeight, top);
+	}
+	else if (block == 0 && top == heightmap[column]) {
+		heightmap[column] = uint16_t(FindTop(column, top - 1));
+		//Only the highest column can lower the chunk's height
+		if (top == maxHeight) {
+			maxHeight = *std::max_element(heightmap.begin(), heightmap.end());
+		}
+	}
+}
+
+void Chunk::FillSection(int section, BlockID block) {
+	BlockStorage& storage = sections[section];
+	if (storage.IsUniform()) {
+		AddBlocks(storage.UniformBlock(), -SECTION_VOLUME);
+	}
+	else {
+		for (uint32_t i = 0; i < SECTION_VOLUME; i++) {
+			AddBlocks(storage.Get(i), -1);
+		}
+	}
+
+	storage.Fill(block);
+	AddBlocks(block, SECTION_VOLUME);
+
+	uint32_t bottom = section * SECTION_HEIGHT, top = bottom + SECTION_HEIGHT;
+	for (int column = 0; column < CHUNK_SIZE * CHUNK_SIZE; column++) {
+		if (block != 0 && top > heightmap[column]) {
+			heightmap[column] = uint16_t(top);
+		}
+		else if (block == 0 && heightmap[column] > bottom && heightmap[column] <= top) {
+			heightmap[column] = uint16_t(FindTop(column, bottom));
+		}
+	}
+
+	if (block != 0) {
+		maxHeight = std::max(maxHeight, top);
+	}
+	else {
+		maxHeight = *std::max_element(heightmap.begin(), heightmap.end());
+	}
+}
+
+uint32_t Chunk::BlockCount(BlockID block) const {
+	if (block == 0) return CHUNK_VOLUME - nonAir;
+	return block < blockCounts.size() ? blockCounts[block] : 0;
+}
+
+void Chunk::AddBlocks(BlockID block, int32_t count) {
+	if (block == 0) return;
+
+	if (block >= blockCounts.size()) {
+		blockCounts.resize(block + 1, 0);
+	}
+	blockCounts[block] += count;
+	nonAir += count;
+}
+
+uint32_t Chunk::FindTop(int column, int y) const {
+	int x = column % CHUNK_SIZE, z = column / CHUNK_SIZE;
+	while (y > 0) {
+		int section = (y - 1) / SECTION_HEIGHT;
+		if (IsSectionEmpty(section)) {
+			y = section * SECTION_HEIGHT;
+			continue;
+		}
+		if (Get(x, y - 1, z) != 0) break;
+		y--;
+	}
+
+	return uint32_t(y);
+}
+
+//Runs on every chunk loaded from disk, so it works a section at a time rather than going through Get for each block
+void Chunk::RecomputeMetadata() {
+	blockCounts.clear();
+	nonAir = 0;
+	heightmap.fill(0);
+
+	//Top down, so each column's height is settled by the first section with a block in it
+	int unsettled = CHUNK_SIZE * CHUNK_SIZE;
+	std::array<bool, CHUNK_SIZE * CHUNK_SIZE> settled{};
+	for (int section = SECTIONS_PER_CHUNK - 1; section >= 0; section--) {
+		const BlockStorage& storage = sections[section];
+		uint16_t bottom = uint16_t(section * SECTION_HEIGHT);
+		if (storage.IsUniform()) {
+			AddBlocks(storage.UniformBlock(), SECTION_VOLUME);
+			if (storage.UniformBlock() != 0 && unsettled > 0) {
+				for (int column = 0; column < CHUNK_SIZE * CHUNK_SIZE; column++) {
+					if (!settled[column]) heightmap[column] = bottom + SECTION_HEIGHT;
+				}
+				settled.fill(true);
+				unsettled = 0;
+			}
+			continue;
+		}
+
+		std::array<uint32_t, 256> counts{};
+		storage.CountIndices(counts);
+		for (uint32_t i = 0; i < storage.Palette().size(); i++) {
+			if (counts[i] > 0) AddBlocks(storage.Palette()[i], int32_t(counts[i]));
+		}
+
+		for (int column = 0; column < CHUNK_SIZE * CHUNK_SIZE && unsettled > 0; column++) {
+			if (settled[column]) continue;
+			for (int y = SECTION_HEIGHT - 1; y >= 0; y--) {
+				if (storage.Get(y * CHUNK_SIZE * CHUNK_SIZE + column) != 0) {
+					heightmap[column] = uint16_t(bottom + y + 1);
+					settled[column] = true;
+					unsettled--;
+					break;
+				}
+			}
+		}
+	}
+
+	maxHeight = *std::max_element(heightmap.begin(), heightmap.end());
+}
+
+void Chunk::Compact() {
+	for (auto& section : sections) {
+		section.Compact();
+	}
+}
+
+size_t Chunk::MemoryUsage() const {
+	size_t usage = sizeof(Chunk) + blockCounts.capacity() * sizeof(uint32_t);
+	for (const auto& section : sections) {
+		usage += section.MemoryUsage() - sizeof(BlockStorage);
+	}
+	return usage;
+}
+
+void Chunk::Serialize(std::vector<uint8_t>& out) const {
+	size_t start = out.size();
+	for (const auto& section : sections) {
+		section.Serialize(out, start);
+	}
+}
+
+bool Chunk::Deserialize(const uint8_t* data, size_t size, const std::shared_ptr<const void>& owner) {
+	const uint8_t* start = data;
+	const uint8_t* end = data + size;
+	for (auto& section : sections) {
+		if (!section.Deserialize(data, start, end, owner)) return false;
+	}
+
+	RecomputeMetadata();
+	return data == end;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Util/SlabAllocator.h"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+constexpr int CHUNK_SIZE = 16;
+constexpr int MAX_BLOCK_HEIGHT = 256;
+constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * MAX_BLOCK_HEIGHT;
+constexpr int SECTION_HEIGHT = 16;
+constexpr int SECTION_VOLUME = CHUNK_SIZE * CHUNK_SIZE * SECTION_HEIGHT;
+constexpr int SECTIONS_PER_CHUNK = MAX_BLOCK_HEIGHT / SECTION_HEIGHT;
+
+using BlockID = unsigned char;
+//Packed block indices. Every bit width gives a fixed array size per section, so they come out of the slab pools
+using BlockWords = std::vector<uint64_t, PoolAllocator<uint64_t>>;
+
+//Index of a block inside of a chunk column, y-major like the old flat arrays.
+//The low 12 bits are the index inside of the block's section, the rest is the section
+inline constexpr uint32_t BlockIndex(int x, int y, int z) {
+	return y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x;
+}
+
+//Palette compressed block storage. Each block is stored as an index into a palette of the distinct
+//block IDs in the volume, bit-packed into 64 bit words. Indices are 0, 1, 2, 4 or 8 bits wide depending
+//on the palette size, so an index never straddles two words and a volume of a single block takes no storage.
+//The words can also be borrowed from memory owned by someone else (like a mapped region file), in which case
+//they're copied out the first time the storage is written to.
+class BlockStorage {
+public:
+	BlockStorage(uint32_t size = SECTION_VOLUME, BlockID fill = 0);
+	BlockStorage(const BlockStorage& other);
+	BlockStorage(BlockStorage&&) = default;
+	BlockStorage& operator=(const BlockStorage& other);
+	BlockStorage& operator=(BlockStorage&&) = default;
+
+	uint32_t Size() const { return size; }
+	uint32_t BitsPerBlock() const { return bits; }
+	bool IsUniform() const { return bits == 0; }
+	//Only valid when IsUniform()
+	BlockID UniformBlock() const { return uniform; }
+	const std::vector<BlockID>& Palette() const { return palette; }
+	bool IsBorrowed() const { return owner != nullptr; }
+	//Borrowed words aren't counted, they belong to whoever lent them
+	size_t MemoryUsage() const;
+
+	inline BlockID Get(uint32_t index) const;
+	//Returns the block that was there before
+	BlockID Set(uint32_t index, BlockID block);
+	void Fill(BlockID block);
+	//Drop unused palette entries, going back to a uniform volume if only one block is left
+	void Compact();
+	//Number of blocks using each palette entry
+	void CountIndices(std::array<uint32_t, 256>& counts) const;
+
+	//The words are padded to start 8 bytes aligned from out[start]
+	void Serialize(std::vector<uint8_t>& out, size_t start) const;
+	//Returns false if the data is truncated or malformed, leaving the storage unchanged.
+	//With an owner the words are borrowed from the data rather than copied, the owner keeps them alive
+	bool Deserialize(const uint8_t*& data, const uint8_t* start, const uint8_t* end, const std::shared_ptr<const void>& owner = nullptr);
+
+private:
+	uint32_t PaletteIndex(BlockID block);
+	void Resize(uint32_t newBits);
+	//Copy borrowed words into data before writing to them
+	void Own();
+	size_t WordCount() const { return bits == 0 ? 0 : ((size_t)size + (1ull << shift) - 1) >> shift; }
+	inline uint32_t IndexAt(uint32_t index) const;
+
+	std::vector<BlockID> palette;
+	BlockWords data;
+	const uint64_t* words = nullptr; //data.data(), or the borrowed words
+	std::shared_ptr<const void> owner;
+	uint32_t size;
+	uint32_t bits = 0;
+	uint32_t shift = 0; //log2 of the indices per word
+	uint64_t mask = 0;
+	BlockID uniform;
+};
+
+inline uint32_t BlockStorage::IndexAt(uint32_t index) const {
+	uint64_t word = words[index >> shift];
+	uint32_t offset = (index & ((1u << shift) - 1u)) * bits;
+	return uint32_t((word >> offset) & mask);
+}
+
+inline BlockID BlockStorage::Get(uint32_t index) const {
+	if (bits == 0) return uniform;
+	return palette[IndexAt(index)];
+}
+
+//A column of CHUNK_SIZE x MAX_BLOCK_HEIGHT x CHUNK_SIZE blocks, split into SECTION_HEIGHT tall sections.
+//Sections made of a single block (usually air or stone) store no block data at all.
+//Block counts and the heightmap are kept up to date as blocks are written, so reading them is free.
+class Chunk {
+public:
+	inline BlockID Get(uint32_t index) const;
+	BlockID Get(int x, int y, int z) const { return Get(BlockIndex(x, y, z)); }
+	void Set(uint32_t index, BlockID block);
+	void Set(int x, int y, int z, BlockID block) { Set(BlockIndex(x, y, z), block); }
+
+	const BlockStorage& Section(int section) const { return sections[section]; }
+	void FillSection(int section, BlockID block);
+	bool IsSectionUniform(int section) const { return sections[section].IsUniform(); }
+	bool IsSectionEmpty(int section) const { return sections[section].IsUniform() && sections[section].UniformBlock() == 0; }
+
+	uint32_t NumBlocks() const { return nonAir; }
+	uint32_t BlockCount(BlockID block) const;
+	//One above the highest non-air block in the column, 0 if the column is empty
+	uint32_t Height(int x, int z) const { return heightmap[z * CHUNK_SIZE + x]; }
+	//Highest Height() in the chunk
+	uint32_t MaxHeight() const { return maxHeight; }
+
+	void Compact();
+	size_t MemoryUsage() const;
+
+	//Byte stream of the sections as they are in memory, in native byte order. The block words of each section
+	//are 8 bytes aligned from the start of the stream, so a stream that is itself aligned can be read in place
+	void Serialize(std::vector<uint8_t>& out) const;
+	//With an owner, sections point into the data instead of copying it and the owner is kept alive until they're written to
+	bool Deserialize(const uint8_t* data, size_t size, const std::shared_ptr<const void>& owner = nullptr);
+
+private:
+	void AddBlocks(BlockID block, int32_t count);
+	//Walks down the column from y to find the top of the highest block under it
+	uint32_t FindTop(int column, int y) const;
+	void RecomputeMetadata();
+
+	std::array<BlockStorage, SECTIONS_PER_CHUNK> sections;
+	std::array<uint16_t, CHUNK_SIZE * CHUNK_SIZE> heightmap{};
+	//Indexed by block ID, only as long as the highest ID that has been placed. Air isn't counted here
+	std::vector<uint32_t> blockCounts;
+	uint32_t nonAir = 0;
+	uint32_t maxHeight = 0;
+};
+
+inline BlockID Chunk::Get(uint32_t index) const {
+	return sections[index / SECTION_VOLUME].Get(index % SECTION_VOLUME);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "ChunkEdits.h"
+#include "Block.h"
+
+#include <algorithm>
+#include <cstring>
+
+void ChunkEdits::Set(uint32_t index, BlockID block) {
+	uint32_t edit = (index << 8) | block;
+	auto iter = std::lower_bound(edits.begin(), edits.end(), index << 8);
+	if (iter != edits.end() && Index(*iter) == index) {
+		*iter = edit;
+	}
+	else {
+		edits.insert(iter, edit);
+	}
+}
+
+void ChunkEdits::Apply(Chunk& chunk) const {
+	for (uint32_t edit : edits) {
+		chunk.Set(Index(edit), Block(edit));
+	}
+}
+
+void ChunkEdits::Serialize(std::vector<uint8_t>& out) const {
+	size_t start = out.size();
+	out.resize(start + edits.size() * sizeof(uint32_t));
+	std::memcpy(out.data() + start, edits.data(), edits.size() * sizeof(uint32_t));
+}
+
+bool ChunkEdits::Deserialize(const uint8_t* data, size_t size) {
+	if (size % sizeof(uint32_t) != 0) return false;
+
+	std::vector<uint32_t> newEdits(size / sizeof(uint32_t));
+	std::memcpy(newEdits.data(), data, size);
+	for (size_t i = 0; i < newEdits.size(); i++) {
+		if (Index(newEdits[i]) >= uint32_t(CHUNK_VOLUME)) return false;
+		if (!IsBlockID(Block(newEdits[i]))) return false;
+		if (i > 0 && Index(newEdits[i]) <= Index(newEdits[i - 1])) return false;
+	}
+
+	edits = std::move(newEdits);
+	return true;
+}
\ No newline at end of file
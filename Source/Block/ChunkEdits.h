@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ChunkData.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//The blocks the player has changed in a chunk. Generation is a pure function of the seed and the chunk's position,
+//so this is all that has to be saved of it: loading generates the chunk again and writes these over it.
+//One entry per block, the block it was last set to, sorted by block index
+class ChunkEdits {
+public:
+	void Set(uint32_t index, BlockID block);
+	void Set(int x, int y, int z, BlockID block) { Set(BlockIndex(x, y, z), block); }
+
+	bool Empty() const { return edits.empty(); }
+	size_t Size() const { return edits.size(); }
+	size_t MemoryUsage() const { return edits.capacity() * sizeof(uint32_t); }
+
+	//Writes the edits over a freshly generated chunk
+	void Apply(Chunk& chunk) const;
+
+	//A packed word per edit, the block index above the block ID, in native byte order
+	void Serialize(std::vector<uint8_t>& out) const;
+	bool Deserialize(const uint8_t* data, size_t size);
+
+private:
+	static uint32_t Index(uint32_t edit) { return edit >> 8; }
+	static BlockID Block(uint32_t edit) { return BlockID(edit & 0xFF); }
+
+	std::vector<uint32_t> edits;
+};
\ No newline at end of file
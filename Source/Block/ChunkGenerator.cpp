@@ -0,0 +1,284 @@
+#include "ChunkGenerator.h"
+#include "Util/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+//Salts for the random streams of each feature, so they don't line up when they're rooted in the same column
+constexpr uint32_t TREE_SALT = 1;
+//Salts for the permutation tables of the noise layers, so the layers of a world aren't copies of each other
+constexpr uint32_t HEIGHT_SALT = 2;
+constexpr uint32_t DETAIL_SALT = 3;
+constexpr uint32_t SAND_SALT = 4;
+constexpr uint32_t TEMPERATURE_SALT = 5;
+constexpr uint32_t HUMIDITY_SALT = 6;
+
+//Tree leaves reach this far out from the trunk
+constexpr int TREE_RADIUS = 2;
+constexpr int COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+
+//Samples of a noise layer, a point per column or a coarser lattice that also takes in the first row and
+//column of the next chunks, so neighboring chunks interpolate between the same samples and meet without a seam
+using LatticeValues = std::array<float, (CHUNK_SIZE + 1) * (CHUNK_SIZE + 1)>;
+
+struct Lattice {
+	int step;
+	int size; //Samples along each side
+	int count;
+
+	static Lattice Of(int step) {
+		int size = step == 1 ? CHUNK_SIZE : CHUNK_SIZE / step + 1;
+		return Lattice{ step, size, size * size };
+	}
+
+	int OffsetX(int sample) const { return sample % size * step; }
+	int OffsetZ(int sample) const { return sample / size * step; }
+
+	//World positions of the samples
+	void Positions(const glm::ivec2& chunkID, LatticeValues& xs, LatticeValues& zs) const {
+		for (int i = 0; i < count; i++) {
+			xs[i] = float(OffsetX(i) + chunkID.x * CHUNK_SIZE);
+			zs[i] = float(OffsetZ(i) + chunkID.y * CHUNK_SIZE);
+		}
+	}
+
+	//Bilinearly interpolated value at a column, x and z may also be CHUNK_SIZE on a coarse lattice
+	float Sample(const LatticeValues& values, int x, int z) const {
+		if (step == 1) return values[z * CHUNK_SIZE + x];
+
+		int cellX = std::min(x / step, size - 2), cellZ = std::min(z / step, size - 2);
+		float fx = float(x - cellX * step) / step, fz = float(z - cellZ * step) / step;
+		const float* row = &values[cellZ * size + cellX];
+		float top = row[0] + (row[1] - row[0]) * fx;
+		float bottom = row[size] + (row[size + 1] - row[size]) * fx;
+		return top + (bottom - top) * fz;
+	}
+};
+
+int DecorationView::TerrainHeight(int x, int z) const {
+	int dx = x < 0 ? -1 : (x >= CHUNK_SIZE ? 1 : 0);
+	int dz = z < 0 ? -1 : (z >= CHUNK_SIZE ? 1 : 0);
+	return int(terrain[(dz + 1) * 3 + dx + 1]->Height(x - dx * CHUNK_SIZE, z - dz * CHUNK_SIZE)) - 1;
+}
+
+void DecorationView::Set(int x, int y, int z, BlockID block) {
+	if (x < 0 || x >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE || y < 0 || y >= MAX_BLOCK_HEIGHT) return;
+	center.Set(x, y, z, block);
+}
+
+//Adds the time since the last lap to a stage of the timings, does nothing without timings
+class StageTimer {
+public:
+	explicit StageTimer(GenerationTimings* timings) : timings(timings) {
+		if (timings) last = std::chrono::steady_clock::now();
+	}
+
+	void Lap(double GenerationTimings::* stage) {
+		if (!timings) return;
+		auto now = std::chrono::steady_clock::now();
+		timings->*stage += std::chrono::duration<double>(now - last).count();
+		last = now;
+	}
+
+private:
+	GenerationTimings* timings;
+	std::chrono::steady_clock::time_point last;
+};
+
+//Seed 0 keeps the classic noise table for every layer. The biomes change the heights and blocks for every seed though,
+//so worlds from before seeds existed don't generate the same anymore: their saved chunks are kept whole, but the
+//chunks generated next to them won't line up
+static uint64_t LayerSeed(uint64_t seed, uint32_t salt) {
+	return seed == 0 ? 0 : Random::Key(seed, 0, 0, salt);
+}
+
+ChunkGenerator::ChunkGenerator(uint64_t seed, const TerrainSampling& sampling) :
+	seed(seed),
+	sampling(sampling),
+	height(0.006f, 10.f, 2.1f, 0.45f, LayerSeed(seed, HEIGHT_SALT)),
+	detail(1.f, 1.f, 1.8f, 0.6f, LayerSeed(seed, DETAIL_SALT)),
+	sand(0.006f, 1.f, 2.f, 0.5f, LayerSeed(seed, SAND_SALT)),
+	//No world ever had these layers with the classic table, so they're salted even for seed 0
+	biomes(Random::Key(seed, 0, 0, TEMPERATURE_SALT), Random::Key(seed, 0, 0, HUMIDITY_SALT)) {
+	for (int step : { sampling.detailStep, sampling.heightStep, sampling.sandStep }) {
+		if (step < 1 || CHUNK_SIZE % step != 0) {
+			throw std::runtime_error("Terrain sampling step " + std::to_string(step) + " doesn't divide the chunk size!");
+		}
+	}
+}
+
+std::shared_ptr<Chunk> ChunkGenerator::GenerateTerrain(const glm::ivec2& chunkID, GenerationTimings* timings) const {
+	StageTimer timer(timings);
+	auto result = std::make_shared<Chunk>();
+	Chunk& chunk = *result;
+
+	//The noise layers are evaluated in batches, a SIMD lane per sample
+	Lattice warpLattice = Lattice::Of(sampling.heightStep), detailLattice = Lattice::Of(sampling.detailStep);
+	LatticeValues xs, zs, noise;
+	warpLattice.Positions(chunkID, xs, zs);
+
+	//Truncated to whole blocks on purpose, the warp only kicks in where the detail noise reaches 1.
+	//It's needed wherever the height is sampled, interpolated from the detail's own lattice if that's coarse
+	LatticeValues warp;
+	if (sampling.detailStep == 1) {
+		this->detail.fractal(8, xs.data(), zs.data(), warp.data(), warpLattice.count);
+	}
+	else {
+		LatticeValues detailXs, detailZs, detailNoise;
+		detailLattice.Positions(chunkID, detailXs, detailZs);
+		this->detail.fractal(8, detailXs.data(), detailZs.data(), detailNoise.data(), detailLattice.count);
+		for (int i = 0; i < warpLattice.count; i++) {
+			warp[i] = detailLattice.Sample(detailNoise, warpLattice.OffsetX(i), warpLattice.OffsetZ(i));
+		}
+	}
+
+	LatticeValues warpedX, warpedZ;
+	for (int i = 0; i < warpLattice.count; i++) {
+		int offset = int(warp[i]);
+		warpedX[i] = xs[i] + 80.f * offset;
+		warpedZ[i] = zs[i] + 80.f * offset;
+	}
+
+	//The biome decides how tall the terrain is and what it's covered with
+	std::shared_ptr<const BiomeRegion> biomeRegion = biomes.Region(BiomeMap::RegionOf(chunkID));
+	glm::ivec2 regionOffset = BiomeMap::OffsetInRegion(chunkID);
+	std::array<Biome, COLUMNS> columnBiomes;
+
+	std::array<int, COLUMNS> heights, sandNoises;
+	int minHeight = MAX_BLOCK_HEIGHT;
+	this->height.fractal(14, warpedX.data(), warpedZ.data(), noise.data(), warpLattice.count);
+	for (int column = 0; column < COLUMNS; column++) {
+		int x = column % CHUNK_SIZE, z = column / CHUNK_SIZE;
+		float scale, offset;
+		biomeRegion->HeightParams(regionOffset.x + x, regionOffset.y + z, scale, offset);
+		columnBiomes[column] = biomeRegion->At(regionOffset.x + x, regionOffset.y + z);
+		heights[column] = int(warpLattice.Sample(noise, x, z) * scale + offset);
+		minHeight = std::min(minHeight, heights[column]);
+	}
+
+	Lattice sandLattice = Lattice::Of(sampling.sandStep);
+	sandLattice.Positions(chunkID, xs, zs);
+	sand.noise(xs.data(), zs.data(), noise.data(), sandLattice.count);
+	for (int column = 0; column < COLUMNS; column++) {
+		sandNoises[column] = int(sandLattice.Sample(noise, column % CHUNK_SIZE, column / CHUNK_SIZE) * 2.f);
+	}
+	timer.Lap(&GenerationTimings::noise);
+
+	//Sections entirely below the dirt layer are solid stone, so fill them without touching the blocks
+	int stoneSections = std::clamp((minHeight - 1) / SECTION_HEIGHT, 0, SECTIONS_PER_CHUNK);
+	for (int section = 0; section < stoneSections; section++) {
+		chunk.FillSection(section, 3); //Stone
+	}
+
+	for (int x = 0; x < CHUNK_SIZE; x++) {
+		for (int z = 0; z < CHUNK_SIZE; z++) {
+			int height = heights[z * CHUNK_SIZE + x];
+			int sandNoise = sandNoises[z * CHUNK_SIZE + x];
+			const BiomeInfo& biome = GetBiomeInfo(columnBiomes[z * CHUNK_SIZE + x]);
+			BlockID surface = height > biome.bareAbove ? 3 : biome.surface; //Stone
+			BlockID subsurface = height > biome.bareAbove ? 3 : biome.subsurface;
+			//Everything above the water and terrain is left as empty sections
+			for (int y = stoneSections * SECTION_HEIGHT; y < MAX_BLOCK_HEIGHT; y++) {
+				if (y == height) {
+					if (y > 66 + sandNoise) {
+						chunk.Set(x, y, z, surface);
+					}
+					else {
+						chunk.Set(x, y, z, 7); //Sand
+					}
+				}
+				else if (y > height - 2 && y < height) {
+					if (y > 66 + sandNoise) {
+						chunk.Set(x, y, z, subsurface);
+					}
+					else {
+						chunk.Set(x, y, z, 7); //Sand
+					}
+				}
+				else if (y < height) {
+					chunk.Set(x, y, z, 3); //Stone
+				}
+				else if (y < 64) {
+					chunk.Set(x, y, z, 4); //Water
+				}
+				else {
+					break;
+				}
+			}
+		}
+	}
+
+	//Sections written block by block may still have ended up as a single block
+	chunk.Compact();
+	timer.Lap(&GenerationTimings::fill);
+	return result;
+}
+
+std::shared_ptr<Chunk> ChunkGenerator::Decorate(const glm::ivec2& chunkID, const TerrainNeighborhood& terrain, GenerationTimings* timings) const {
+	StageTimer timer(timings);
+	auto result = std::make_shared<Chunk>(*terrain[4]);
+	DecorationView view(terrain, *result);
+
+	//The columns trees can be rooted in reach into the neighbors, which may be in the next biome regions over.
+	//They're all cached from generating the terrain, so fetch them once here instead of once per column
+	glm::ivec2 firstRegion = BiomeMap::RegionOf(chunkID - 1), lastRegion = BiomeMap::RegionOf(chunkID + 1);
+	std::array<std::shared_ptr<const BiomeRegion>, 4> biomeRegions;
+	for (int i = 0; i < 4; i++) {
+		glm::ivec2 regionID = firstRegion + glm::ivec2(i % 2, i / 2);
+		if (regionID.x <= lastRegion.x && regionID.y <= lastRegion.y) {
+			biomeRegions[i] = biomes.Region(regionID);
+		}
+	}
+
+	//Trees rooted in the neighbors close enough to hang into this chunk are placed too, the view keeps only this chunk's part
+	for (int x = -TREE_RADIUS; x < CHUNK_SIZE + TREE_RADIUS; x++) {
+		for (int z = -TREE_RADIUS; z < CHUNK_SIZE + TREE_RADIUS; z++) {
+			glm::ivec2 neighborID = chunkID + glm::ivec2(x < 0 ? -1 : x / CHUNK_SIZE, z < 0 ? -1 : z / CHUNK_SIZE);
+			glm::ivec2 region = BiomeMap::RegionOf(neighborID) - firstRegion;
+			glm::ivec2 column = BiomeMap::OffsetInRegion(neighborID) + glm::ivec2(x - (neighborID.x - chunkID.x) * CHUNK_SIZE, z - (neighborID.y - chunkID.y) * CHUNK_SIZE);
+			Biome biome = biomeRegions[region.y * 2 + region.x]->At(column.x, column.y);
+			PlaceTree(view, x, z, glm::ivec2(x + chunkID.x * CHUNK_SIZE, z + chunkID.y * CHUNK_SIZE), biome);
+		}
+	}
+
+	result->Compact();
+	timer.Lap(&GenerationTimings::decoration);
+	return result;
+}
+
+void ChunkGenerator::PlaceTree(DecorationView& view, int x, int z, const glm::ivec2& block, Biome biome) const {
+	const BiomeInfo& info = GetBiomeInfo(biome);
+	int height = view.TerrainHeight(x, z);
+	if (height <= 66 || height > info.bareAbove) return;
+
+	Random random(seed, block.x, block.y, TREE_SALT);
+	if (random.NextFloat() >= info.treeChance) return;
+
+	for (int y = height; y < height + 5; ++y) {
+		view.Set(x, y, z, 5); //Log
+	}
+
+	//Lower half of leaves
+	for (int leafx = -2; leafx < 3; leafx++) {
+		for (int leafz = -2; leafz < 3; leafz++) {
+			for (int y = 4; y < 6; y++) {
+				if (leafx == 0 && leafz == 0 && y == 4) continue; //Leave one log piece
+				if ((leafx == -2 || leafx == 2) && (leafz == -2 || leafz == 2) && random.NextFloat() > 0.7f) continue;
+				view.Set(x + leafx, height + y, z + leafz, 6); //Leaves
+			}
+		}
+	}
+
+	//Upper half of leaves
+	for (int leafx = -1; leafx < 2; leafx++) {
+		for (int leafz = -1; leafz < 2; leafz++) {
+			for (int y = 6; y < 8; y++) {
+				if (y == 7 && (leafx == -1 || leafx == 1) && (leafz == -1 || leafz == 1) && random.NextFloat() > 0.75f) continue;
+				view.Set(x + leafx, height + y, z + leafz, 6); //Leaves
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ChunkData.h"
+#include "Biome.h"
+#include "Noise/Noise.h"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <memory>
+
+//Generation happens in two stages. Terrain only needs the chunk's own coordinates. Decoration (trees, and whatever
+//else crosses chunk borders) needs the finished terrain of the chunk and all 8 of its neighbors
+enum class GenerationStage {
+	Terrain,
+	Decoration
+};
+
+//A chunk and its 8 neighbors, indexed (dz + 1) * 3 + dx + 1 like ChunkNeighborhood
+using TerrainNeighborhood = std::array<std::shared_ptr<const Chunk>, 9>;
+
+struct GeneratedChunk {
+	glm::ivec2 chunkID{ 0 };
+	GenerationStage stage = GenerationStage::Terrain;
+	std::shared_ptr<Chunk> chunk;
+};
+
+//What decoration gets to touch: reads of the terrain around the chunk, and writes to the chunk itself.
+//Structures are placed relative to the center chunk and may hang into the neighbors, but only the blocks landing
+//in the center are written. The neighbors get the rest when they're decorated, from the same structures, so
+//decorating never writes outside of its own chunk and neighboring chunks can be decorated at the same time
+class DecorationView {
+public:
+	DecorationView(const TerrainNeighborhood& terrain, Chunk& center) : terrain(terrain), center(center) {}
+
+	//Y of the top block of the terrain, -1 if the column is empty. x and z may reach one chunk out on either side
+	int TerrainHeight(int x, int z) const;
+	//Blocks outside of the center chunk are dropped
+	void Set(int x, int y, int z, BlockID block);
+
+private:
+	const TerrainNeighborhood& terrain;
+	Chunk& center;
+};
+
+//How finely each noise layer is sampled, in columns between samples. The columns in between are bilinearly interpolated,
+//which takes far fewer noise evaluations but smooths away detail smaller than the step. 1 evaluates the noise at every
+//column, anything else has to divide CHUNK_SIZE. The same world needs the same sampling, or chunks won't line up and
+//saved edits land on different terrain, so it's saved with the world
+struct TerrainSampling {
+	int detailStep = 1; //Domain warp of the height
+	int heightStep = 1;
+	int sandStep = 1;
+
+	//A 4x4 lattice per chunk for everything, about a tenth of the noise evaluations
+	static TerrainSampling Coarse() { return TerrainSampling{ 4, 4, 4 }; }
+};
+
+//Seconds spent in each part of generation, for benchmarking. The generator adds to them when it's given one
+struct GenerationTimings {
+	double noise = 0.0; //Evaluating the noise layers
+	double fill = 0.0; //Writing the terrain's blocks
+	double decoration = 0.0;
+};
+
+//Goes up whenever the same seed and sampling would generate different blocks. Saves only keep the player's edits,
+//so a world can only be loaded by the version that generated it (see ChunkManager::WorldGenerator).
+//1: seeded noise layers and structures. 2: biomes shape the heights and pick the blocks
+constexpr uint32_t GENERATOR_VERSION = 2;
+
+//Turns chunk coordinates into terrain and decorates it. Both stages only read the generator and return a brand new
+//chunk, so any number of threads can call them at once.
+//Doesn't touch Vulkan, so the benchmarks can use it too
+class ChunkGenerator {
+public:
+	//Worlds with the same seed come out block for block the same, whatever order and however many threads they're generated with
+	explicit ChunkGenerator(uint64_t seed = 0, const TerrainSampling& sampling = TerrainSampling{});
+
+	uint64_t Seed() const { return seed; }
+	const TerrainSampling& Sampling() const { return sampling; }
+	const BiomeMap& Biomes() const { return biomes; }
+	std::shared_ptr<Chunk> GenerateTerrain(const glm::ivec2& chunkID, GenerationTimings* timings = nullptr) const;
+	//A decorated copy of the center of the neighborhood, which must all have been through GenerateTerrain
+	std::shared_ptr<Chunk> Decorate(const glm::ivec2& chunkID, const TerrainNeighborhood& terrain, GenerationTimings* timings = nullptr) const;
+
+private:
+	void PlaceTree(DecorationView& view, int x, int z, const glm::ivec2& block, Biome biome) const;
+
+	uint64_t seed;
+	TerrainSampling sampling;
+	//Each layer gets a permutation table of its own, derived from the world seed
+	SimplexNoise height, detail, sand;
+	BiomeMap biomes;
+};
\ No newline at end of file
@@ -1,11 +1,48 @@
 #include "ChunkManager.h"
+#include "ChunkMesher.h"
 #include "Util\Raytrace.h"
 
-ChunkManager::ChunkManager(Device& device) : device(device) {
-	
+#include <random>
+
+ChunkManager::ChunkManager(Device& device, const ChunkStorageSettings& settings, const ChunkMeshSettings& meshSettings, const ChunkGenerationSettings& generationSettings)
+	: settings(settings), meshSettings(meshSettings), device(device), generator(WorldGenerator(settings.directory, generationSettings)), generationQueue(generator, generationSettings.threads), generationSettings(generationSettings) {
+	SlabAllocator::SetHugePages(settings.hugePages);
+
+	std::vector<uint16_t> indices = QuadIndices();
+	quadIndices = std::make_unique<Buffer>(
+		device,
+		sizeof(uint16_t),
+		indices.size(),
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+		Device::QueueFamilyIndices::Graphics,
+		0u,
+		MemoryCategory::ChunkMeshes
+		);
+	quadIndices->Map();
+	quadIndices->WriteToBuffer((void*)indices.data());
+	quadIndices->Flush();
+	quadIndices->UnMap();
+}
+
+ChunkManager::~ChunkManager() {
+	//Write out everything still in memory so the region files hold the whole world
+	std::vector<glm::ivec2> resident;
+	for (const auto& kv : world) {
+		resident.push_back(kv.first);
+	}
+
+	for (const auto& chunkID : resident) {
+		EvictChunk(chunkID);
+	}
 }
 
 void ChunkManager::Update(const UpdateEvent& event) {
+	currentTime = event.elapsedTime;
+	frameCount++;
+	UnloadMeshes(event.mainCamera.GetPos());
+	PublishChunks();
+
 	for (int x = -RENDER_DISTANCE - 1; x < RENDER_DISTANCE + 1; ++x) {
 		for (int z = -RENDER_DISTANCE - 1; z < RENDER_DISTANCE + 1; ++z) {
 			glm::ivec2 chunkPos{ x, z };
@@ -30,19 +67,58 @@ void ChunkManager::Update(const UpdateEvent& event) {
 			< glm::length(glm::vec2(b) - glm::vec2(event.mainCamera.GetPos().x, event.mainCamera.GetPos().z) / (float)CHUNK_SIZE);
 		});
 
-	//Update closest chunks
-	for (const auto& chunkID : sortedChunks) {
+	glm::vec2 focus = glm::vec2(event.mainCamera.GetPos().x, event.mainCamera.GetPos().z) / float(CHUNK_SIZE);
+	glm::vec2 lookAhead = LookAhead();
+	meshOrder = sortedChunks;
+	if (lookAhead != glm::vec2(0.f)) {
+		std::sort(meshOrder.begin(), meshOrder.end(), [&](const glm::ivec2& a, const glm::ivec2& b) {
+			return SquaredPathDistance(glm::vec2(a), focus, lookAhead) < SquaredPathDistance(glm::vec2(b), focus, lookAhead);
+			});
+	}
+
+	//Update the closest chunk to the camera's path that has itself and all of its neighbors generated, and queue up the
+	//chunks the others are waiting on. The workers take the closest first, so meshes still fill in from the camera out
+	missingChunks.clear();
+	bool meshed = false;
+	for (const auto& chunkID : meshOrder) {
 		ChunkMesh& chunk = *chunks[chunkID];
 		if (chunk.ShouldUpdate()) {
+			bool ready = true;
 			for (int i = 0; i < 9; i++) {
-				GenerateChunk(glm::ivec2(i % 3 - 1, i / 3 - 1) + chunkID);
+				glm::ivec2 neighborID = glm::ivec2(i % 3 - 1, i / 3 - 1) + chunkID;
+				if (!IsGenerated(neighborID)) {
+					missingChunks.push_back(neighborID);
+					ready = false;
+				}
 			}
 
-			chunk.Update(event);
-			break;
+			if (ready && !meshed) {
+				chunk.Update(event);
+				meshed = true;
+			}
+		}
+	}
+
+	//Get everything in range of where the camera is headed generated before it's there, so flying fast doesn't outrun generation
+	if (glm::length(lookAhead) >= 1.f) {
+		glm::ivec2 ahead = glm::ivec2(focus + lookAhead);
+		for (int x = -RENDER_DISTANCE - 1; x <= RENDER_DISTANCE + 1; x++) {
+			for (int z = -RENDER_DISTANCE - 1; z <= RENDER_DISTANCE + 1; z++) {
+				if (x * x + z * z > (RENDER_DISTANCE + 1) * (RENDER_DISTANCE + 1)) continue;
+				if (!IsGenerated(ahead + glm::ivec2(x, z))) {
+					missingChunks.push_back(ahead + glm::ivec2(x, z));
+				}
+			}
 		}
 	}
 
+	if (glm::ivec2(focus) != glm::ivec2(generationFocus) || glm::ivec2(focus + lookAhead) != glm::ivec2(generationFocus + generationLookAhead) || frameCount == 1) {
+		generationFocus = focus;
+		generationLookAhead = lookAhead;
+		generationQueue.SetFocus(focus, float(std::max(generationSettings.dropDistance, RENDER_DISTANCE + 2)), lookAhead);
+	}
+	RequestChunks(missingChunks);
+
 	//Sort neccessary chunks
 	glm::ivec2 chunkID;
 	BlockToChunk(glm::ivec3(event.mainCamera.GetPos().x + CHUNK_SIZE / 2, 0, event.mainCamera.GetPos().z + CHUNK_SIZE / 2), chunkID);
@@ -62,6 +138,10 @@ void ChunkManager::Update(const UpdateEvent& event) {
 	oldPlayerChunk = chunkID;
 	oldPlayerPos = glm::ivec3(event.mainCamera.GetPos());
 
+	if (event.elapsedTime - lastEvictionTime >= EVICTION_INTERVAL) {
+		EvictChunks(chunkID, event.elapsedTime);
+	}
+
 	int i = 0;
 	for (const auto& chunkID : sortedChunks) {
 		ChunkMesh& chunk = *chunks[chunkID];
@@ -86,14 +166,23 @@ bool ChunkManager::VoxelRaytrace(glm::vec3 pos, const glm::vec3& dir, float tMax
 	float minDist = tMax;
 
 	for (int x = min.x; x <= max.x; x++) {
-		for (int y = min.y; y <= max.y; y++) {
-			for (int z = min.z; z <= max.z; z++) {
-				glm::ivec3 blockPos{ x, y, z };
-				glm::ivec2 chunkID;
-				glm::ivec3 chunkBlockPos = BlockToChunk(blockPos, chunkID);
+		for (int z = min.z; z <= max.z; z++) {
+			glm::ivec2 chunkID;
+			glm::ivec3 chunkBlockPos = BlockToChunk(glm::ivec3{ x, 0, z }, chunkID);
+
+			auto chunk = world.find(chunkID);
+			if (chunk == world.end()) continue;
 
-				if (world.contains(chunkID) && world.find(chunkID)->second[chunkBlockPos.y * CHUNK_SIZE * CHUNK_SIZE + chunkBlockPos.z * CHUNK_SIZE + chunkBlockPos.x] > 0
-					&& !(blocks[world.find(chunkID)->second[chunkBlockPos.y * CHUNK_SIZE * CHUNK_SIZE + chunkBlockPos.z * CHUNK_SIZE + chunkBlockPos.x] - 1].flags & Block::LIQUID)) {
+			for (int y = std::max(min.y, 0); y <= std::min(max.y, MAX_BLOCK_HEIGHT - 1); y++) {
+				//Jump over empty sections
+				if (chunk->second->IsSectionEmpty(y / SECTION_HEIGHT)) {
+					y = (y / SECTION_HEIGHT + 1) * SECTION_HEIGHT - 1;
+					continue;
+				}
+
+				glm::ivec3 blockPos{ x, y, z };
+				BlockID blockID = chunk->second->Get(chunkBlockPos.x, y, chunkBlockPos.z);
+				if (blockID > 0 && !(blocks[blockID - 1].flags & Block::LIQUID)) {
 					glm::vec3 minBounds = glm::vec3{ blockPos };
 					glm::vec3 maxBounds = glm::vec3{ blockPos } + glm::vec3{ 1.f };
 
@@ -102,7 +191,7 @@ bool ChunkManager::VoxelRaytrace(glm::vec3 pos, const glm::vec3& dir, float tMax
 						if (hit.t < minDist && hit.t > 0.f) {
 							minInfo.blockPos = blockPos;
 							minInfo.chunkID = chunkID;
-							minInfo.blockID = world.find(chunkID)->second[chunkBlockPos.y * CHUNK_SIZE * CHUNK_SIZE + chunkBlockPos.z * CHUNK_SIZE + chunkBlockPos.x];
+							minInfo.blockID = blockID;
 							minInfo.block = blocks[minInfo.blockID - 1];
 							minInfo.normal = hit.normal;
 							minInfo.dist = hit.t;
@@ -127,167 +216,547 @@ bool ChunkManager::VoxelRaytrace(glm::vec3 pos, const glm::vec3& dir, float tMax
 void ChunkManager::BreakBlock(const glm::ivec3& pos, const UpdateEvent& event) {
 	glm::ivec2 chunkID;
 	glm::ivec3 blockPos = BlockToChunk(pos, chunkID);
-	world[chunkID][blockPos.y * CHUNK_SIZE * CHUNK_SIZE + blockPos.z * CHUNK_SIZE + blockPos.x] = 0;
+	SetBlock(chunkID, blockPos, 0);
 	if (blockPos.x == 0) {
-		chunks[chunkID + glm::ivec2(-1, 0)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(-1, 0)]->shouldResort = true;
-		chunks[chunkID + glm::ivec2(-1, 0)]->Update(event);
+		InvalidateMesh(chunkID + glm::ivec2(-1, 0), &event);
 	}
 	else if (blockPos.x == CHUNK_SIZE - 1) {
-		chunks[chunkID + glm::ivec2(1, 0)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(1, 0)]->shouldResort = true;
-		chunks[chunkID + glm::ivec2(1, 0)]->Update(event);
+		InvalidateMesh(chunkID + glm::ivec2(1, 0), &event);
 	}
 	if (blockPos.z == 0) {
-		chunks[chunkID + glm::ivec2(0, -1)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(0, -1)]->shouldResort = true;
-		chunks[chunkID + glm::ivec2(0, -1)]->Update(event);
+		InvalidateMesh(chunkID + glm::ivec2(0, -1), &event);
 	}
 	else if (blockPos.z == CHUNK_SIZE - 1) {
-		chunks[chunkID + glm::ivec2(0, 1)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(0, 1)]->shouldResort = true;
-		chunks[chunkID + glm::ivec2(0, 1)]->Update(event);
+		InvalidateMesh(chunkID + glm::ivec2(0, 1), &event);
 	}
-	chunks[chunkID]->shouldUpdate = true;
-	chunks[chunkID]->shouldResort = true;
+	InvalidateMesh(chunkID);
 }
 
 void ChunkManager::PlaceBlock(const glm::ivec3& pos, BlockID block, const UpdateEvent& event) {
 	glm::ivec2 chunkID;
 	glm::ivec3 blockPos = BlockToChunk(pos, chunkID);
 
-	world[chunkID][blockPos.y * CHUNK_SIZE * CHUNK_SIZE + blockPos.z * CHUNK_SIZE + blockPos.x] = block;
+	SetBlock(chunkID, blockPos, block);
 	if (blockPos.x == 0) {
-		chunks[chunkID + glm::ivec2(-1, 0)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(-1, 0)]->shouldResort = true;
+		InvalidateMesh(chunkID + glm::ivec2(-1, 0));
 	}
 	else if (blockPos.x == CHUNK_SIZE - 1) {
-		chunks[chunkID + glm::ivec2(1, 0)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(1, 0)]->shouldResort = true;
+		InvalidateMesh(chunkID + glm::ivec2(1, 0));
 	}
 	if (blockPos.z == 0) {
-		chunks[chunkID + glm::ivec2(0, -1)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(0, -1)]->shouldResort = true;
+		InvalidateMesh(chunkID + glm::ivec2(0, -1));
 	}
 	else if (blockPos.z == CHUNK_SIZE - 1) {
-		chunks[chunkID + glm::ivec2(0, 1)]->shouldUpdate = true;
-		chunks[chunkID + glm::ivec2(0, 1)]->shouldResort = true;
+		InvalidateMesh(chunkID + glm::ivec2(0, 1));
 	}
-	chunks[chunkID]->shouldUpdate = true;
-	chunks[chunkID]->shouldResort = true;
+	InvalidateMesh(chunkID);
 }
 
-void ChunkManager::GenerateChunk(const glm::ivec2& chunkID) {
-	if (!world.contains(chunkID) || loadedChunks[chunkID] == false) {
-		for (int x = 0; x < CHUNK_SIZE; x++) {
-			for (int z = 0; z < CHUNK_SIZE; z++) {
-				glm::ivec2 block{ x + chunkID.x * CHUNK_SIZE, z + chunkID.y * CHUNK_SIZE };
-				int noise1 = this->detail.fractal(8, block.x, block.y);
-				int noise2 = this->detail.fractal(8, block.x, block.y);
-				int height = this->height.fractal(14, block.x + 80.f * noise1, block.y + 80.f * noise2) * 26.f + 70.f;
-				
-				int sandNoise = sand.noise(block.x, block.y) * 2.f;
-				//height += this->detail.fractal(6, block.x, block.y) * 4.f;
-				for (int y = 0; y < MAX_BLOCK_HEIGHT; y++) {
-					if (y == height) {
-						if (y > 66 + sandNoise) {
-							world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 1; //Grass
-						}
-						else {
-							world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 7; //Sand
-						}
-					}
-					else if (y > height - 2 && y < height) {
-						if (y > 66 + sandNoise) {
-							world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 2; //Dirt
-						}
-						else {
-							world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 7; //Sand
-						}
-					}
-					else if (y < height) {
-						world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 3; //Stone
-					}
-					else if (y < 64) {
-						world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 4; //Water
-					}
-					else {
-						break;
-					}
-				}
+void ChunkManager::SetBlock(const glm::ivec2& chunkID, const glm::ivec3& blockPos, BlockID block) {
+	GetChunk(chunkID).Set(blockPos.x, blockPos.y, blockPos.z, block);
+	edits[chunkID].Set(blockPos.x, blockPos.y, blockPos.z, block);
+}
 
-				if (height > 66) {
-					//TODO: better way of generating random numbers
-					//TODO: way of not having to write into nearby chunks that may have already been meshed
-					//because structures exceeding CHUNK_SIZE will still break
-					srand(std::hash<glm::ivec2>{}(block));
-					if (rand() / (float)RAND_MAX > 0.992) {
-						for (int y = height; y < height + 5; ++y) {
-							world[chunkID][y * CHUNK_SIZE * CHUNK_SIZE + z * CHUNK_SIZE + x] = 5; //Log
-						}
+void ChunkManager::InvalidateMesh(const glm::ivec2& chunkID, const UpdateEvent* event) {
+	auto mesh = chunks.find(chunkID);
+	if (mesh == chunks.end()) return;
 
-						//Lower half of leaves
-						for (int leafx = -2; leafx < 3; leafx++) {
-							for (int leafz = -2; leafz < 3; leafz++) {
-								for (int y = 4; y < 6; y++) {
-									glm::ivec3 leafBlockPos{ leafx + x, height + y, leafz + z }; //Local to this chunk
-									if (leafBlockPos.x >= 0 && leafBlockPos.x < CHUNK_SIZE && leafBlockPos.z >= 0 && leafBlockPos.z < CHUNK_SIZE) {
-										if (leafx == 0 && leafz == 0 && y == 4) continue; //Leave one log piece
-										if ((leafx == -2 || leafx == 2) && (leafz == -2 || leafz == 2) && rand() / (float)RAND_MAX > 0.7) continue;
-										world[chunkID][leafBlockPos.y * CHUNK_SIZE * CHUNK_SIZE + leafBlockPos.z * CHUNK_SIZE + leafBlockPos.x] = 6; //Leaves
-									}
-									else {
-										if ((leafx == -2 || leafx == 2) && (leafz == -2 || leafz == 2) && rand() / (float)RAND_MAX > 0.7) continue;
-										//Figure out what chunk to write to
-										glm::ivec2 chunkID;
-										glm::ivec3 blockPos = BlockToChunk(glm::ivec3(block.x + leafx, height + y, block.y + leafz), chunkID);
-										world[chunkID][blockPos.y * CHUNK_SIZE * CHUNK_SIZE + blockPos.z * CHUNK_SIZE + blockPos.x] = 6; //Leaves
-									}
-								}
-							}
-						}
+	mesh->second->shouldUpdate = true;
+	mesh->second->shouldResort = true;
+	if (event) {
+		mesh->second->Update(*event);
+	}
+}
 
-						//Upper half of leaves
-						for (int leafx = -1; leafx < 2; leafx++) {
-							for (int leafz = -1; leafz < 2; leafz++) {
-								//Lower half of leaves
-								for (int y = 6; y < 8; y++) {
-									glm::ivec3 leafBlockPos{ leafx + x, height + y, leafz + z }; //Local to this chunk
-									if (leafBlockPos.x >= 0 && leafBlockPos.x < CHUNK_SIZE && leafBlockPos.z >= 0 && leafBlockPos.z < CHUNK_SIZE) {
-										if (y == 7 && (leafx == -1 || leafx == 1) && (leafz == -1 || leafz == 1) && rand() / (float)RAND_MAX > 0.75) continue;
-										world[chunkID][leafBlockPos.y * CHUNK_SIZE * CHUNK_SIZE + leafBlockPos.z * CHUNK_SIZE + leafBlockPos.x] = 6; //Leaves
-									}
-									else {
-										if (y == 7 && (leafx == -1 || leafx == 1) && (leafz == -1 || leafz == 1) && rand() / (float)RAND_MAX > 0.75) continue;
-										//Figure out what chunk to write to
-										glm::ivec2 chunkID;
-										glm::ivec3 blockPos = BlockToChunk(glm::ivec3(block.x + leafx, height + y, block.y + leafz), chunkID);
-										world[chunkID][blockPos.y * CHUNK_SIZE * CHUNK_SIZE + blockPos.z * CHUNK_SIZE + blockPos.x] = 6; //Leaves
-									}
-								}
-							}
-						}
-					}
-				}
+bool ChunkManager::IsGenerated(const glm::ivec2& chunkID) {
+	if (!world.contains(chunkID)) {
+		//Its region file was already looked at when it was first requested, it's waiting on the workers
+		if (requestedChunks.contains(chunkID)) return false;
+		if (!LoadChunk(chunkID)) {
+			requestedChunks[chunkID] = true;
+			return false;
+		}
+	}
+
+	lastAccess[chunkID] = currentTime;
+	return loadedChunks[chunkID];
+}
+
+void ChunkManager::RequestChunks(std::vector<glm::ivec2>& chunkIDs) {
+	std::sort(chunkIDs.begin(), chunkIDs.end(), [](const glm::ivec2& a, const glm::ivec2& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+	chunkIDs.erase(std::unique(chunkIDs.begin(), chunkIDs.end()), chunkIDs.end());
+
+	//Decoration has to wait for the terrain of all 8 neighbors
+	missingTerrain.clear();
+	decorations.clear();
+	for (const auto& chunkID : chunkIDs) {
+		TerrainNeighborhood terrain;
+		bool ready = true;
+		for (int i = 0; i < 9; i++) {
+			glm::ivec2 neighborID = glm::ivec2(i % 3 - 1, i / 3 - 1) + chunkID;
+			auto neighbor = terrainChunks.find(neighborID);
+			if (neighbor == terrainChunks.end()) {
+				missingTerrain.push_back(neighborID);
+				ready = false;
 			}
+			else {
+				terrain[i] = neighbor->second;
+			}
+		}
+
+		if (ready) {
+			decorations.emplace_back(chunkID, std::move(terrain));
 		}
 	}
 
-	loadedChunks[chunkID] = true;
+	generationQueue.RequestTerrain(missingTerrain);
+	generationQueue.RequestDecoration(decorations);
+	decorations.clear();
 }
 
-uint32_t ChunkManager::MaxBlockHeight(const glm::ivec2& chunk) const {
-	if (!world.contains(chunk)) return 0;
-
-	int max = 0;
-	for (int y = 0; y < MAX_BLOCK_HEIGHT; y++) {
-		for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
-			if (world.find(chunk)->second[y * CHUNK_SIZE * CHUNK_SIZE + i] > 0) {
-				max = y;
-				break;
+glm::vec2 ChunkManager::LookAhead() const {
+	glm::vec2 ahead = glm::vec2(playerVelocity.x, playerVelocity.z) * generationSettings.lookAhead / float(CHUNK_SIZE);
+
+	//What's generated around the end of it has to be inside of the evict distance, or it would be thrown out again right away
+	float maxLength = float(std::max(settings.evictDistance, RENDER_DISTANCE + 2) - RENDER_DISTANCE - 2);
+	float length = glm::length(ahead);
+	if (length > maxLength) {
+		ahead *= maxLength / length;
+	}
+	return ahead;
+}
+
+void ChunkManager::PublishChunks() {
+	generatedChunks.clear();
+	generationQueue.Collect(generatedChunks);
+
+	for (auto& generated : generatedChunks) {
+		const glm::ivec2& chunkID = generated.chunkID;
+		if (generated.stage == GenerationStage::Terrain) {
+			terrainChunks[chunkID] = std::move(generated.chunk);
+			continue;
+		}
+
+		//It may have been evicted and written out while it was being decorated
+		if (!world.contains(chunkID)) {
+			LoadChunk(chunkID);
+		}
+		if (world.contains(chunkID) && loadedChunks[chunkID]) continue;
+
+		//Put back what the player changed, whether it was read back from the region file or made before the chunk was generated
+		auto chunkEdits = edits.find(chunkID);
+		if (chunkEdits != edits.end()) {
+			chunkEdits->second.Apply(*generated.chunk);
+		}
+
+		//Decoration only ever writes to its own chunk, so nothing around it has to be touched or meshed again
+		world[chunkID] = std::move(generated.chunk);
+		requestedChunks.erase(chunkID);
+		loadedChunks[chunkID] = true;
+		unsavedChunks[chunkID] = true;
+		lastAccess[chunkID] = currentTime;
+	}
+	generatedChunks.clear();
+}
+
+Chunk& ChunkManager::GetChunk(const glm::ivec2& chunkID) {
+	lastAccess[chunkID] = currentTime;
+	if (!world.contains(chunkID)) {
+		LoadChunk(chunkID);
+	}
+
+	unsavedChunks[chunkID] = true;
+	return Writable(world[chunkID]);
+}
+
+Chunk& ChunkManager::Writable(std::shared_ptr<Chunk>& chunk) {
+	if (!chunk) {
+		chunk = std::make_shared<Chunk>();
+	}
+	else if (chunk.use_count() > 1) {
+		//Only the main thread hands out new references, so if nobody else holds one now nobody can start to
+		chunk = std::make_shared<Chunk>(*chunk);
+	}
+
+	return *chunk;
+}
+
+bool ChunkManager::LoadChunk(const glm::ivec2& chunkID) {
+	RegionFile& region = Region(chunkID);
+	int x = chunkID.x & (REGION_SIZE - 1), z = chunkID.y & (REGION_SIZE - 1);
+
+	//Only the edits are saved, the chunk itself has to be generated again. They're kept until it is
+	if (region.Flags(x, z) & CHUNK_EDITS) {
+		if (!edits.contains(chunkID) && region.Read(x, z, chunkBuffer)) {
+			ChunkEdits chunkEdits;
+			if (!chunkEdits.Deserialize(chunkBuffer.data(), chunkBuffer.size())) {
+				std::cerr << "Edits of chunk " << chunkID.x << ", " << chunkID.y << " are damaged, it will be generated without them" << std::endl;
 			}
+			edits[chunkID] = std::move(chunkEdits);
+			stats.reloads++;
+		}
+		return false;
+	}
+
+	const uint8_t* data;
+	size_t size;
+	std::shared_ptr<const MappedFile> mapping = region.Map(x, z, data, size);
+	if (!mapping) return false;
+
+	//The sections point straight into the mapped file, only the ones that get edited are copied
+	Chunk chunk;
+	if (!chunk.Deserialize(data, size, mapping)) {
+		std::cerr << "Chunk " << chunkID.x << ", " << chunkID.y << " is damaged, it will be generated again" << std::endl;
+		return false;
+	}
+
+	world[chunkID] = std::make_shared<Chunk>(std::move(chunk));
+	loadedChunks[chunkID] = (region.Flags(x, z) & CHUNK_GENERATED) != 0;
+	//Without the generated flag it's generated over, and saved as edits from then on
+	if (loadedChunks[chunkID]) {
+		wholeChunks[chunkID] = true;
+	}
+	unsavedChunks[chunkID] = false;
+	lastAccess[chunkID] = currentTime;
+	stats.reloads++;
+	return true;
+}
+
+void ChunkManager::EvictChunk(const glm::ivec2& chunkID) {
+	auto chunk = world.find(chunkID);
+	if (chunk == world.end()) return;
+
+	//Chunks that haven't changed since they were loaded are already on disk as they are
+	if (unsavedChunks[chunkID]) {
+		RegionFile& region = Region(chunkID);
+		int x = chunkID.x & (REGION_SIZE - 1), z = chunkID.y & (REGION_SIZE - 1);
+		auto chunkEdits = edits.find(chunkID);
+		bool whole = wholeChunks.contains(chunkID);
+
+		chunkBuffer.clear();
+		if (!whole && chunkEdits != edits.end() && !chunkEdits->second.Empty()) {
+			chunkEdits->second.Serialize(chunkBuffer);
+		}
+
+		//A chunk edited so heavily that its edits take more room than its blocks is saved whole, it can't go back to edits after
+		if (!whole && loadedChunks[chunkID] && chunkBuffer.size() > chunk->second->MemoryUsage()) {
+			whole = true;
+		}
+
+		if (whole) {
+			chunkBuffer.clear();
+			chunk->second->Serialize(chunkBuffer);
+			region.Write(x, z, chunkBuffer, CHUNK_GENERATED);
+		}
+		else if (!chunkBuffer.empty()) {
+			region.Write(x, z, chunkBuffer, CHUNK_EDITS);
+		}
+		else {
+			//Nothing but generated blocks, drop whatever an older save kept of it
+			region.Erase(x, z);
 		}
 	}
 
-	return max + 1;
+	world.erase(chunk);
+	//What was just written has to be read back
+	requestedChunks.erase(chunkID);
+	loadedChunks.erase(chunkID);
+	unsavedChunks.erase(chunkID);
+	edits.erase(chunkID);
+	wholeChunks.erase(chunkID);
+	lastAccess.erase(chunkID);
+	stats.evictions++;
+}
+
+void ChunkManager::EvictChunks(const glm::ivec2& playerChunk, float time) {
+	int evictDistance = std::max(settings.evictDistance, RENDER_DISTANCE + 2);
+
+	//Anything past the evict distance goes, chunks between it and the render distance go if we're over budget
+	std::vector<glm::ivec2> farChunks;
+	std::vector<std::pair<float, glm::ivec2>> coldChunks;
+	size_t residentBytes = 0;
+	for (const auto& kv : world) {
+		residentBytes += kv.second->MemoryUsage();
+		glm::ivec2 offset = glm::abs(kv.first - playerChunk);
+		int dist = std::max(offset.x, offset.y);
+		if (dist > evictDistance) {
+			farChunks.push_back(kv.first);
+		}
+		else if (dist > RENDER_DISTANCE + 2) {
+			coldChunks.emplace_back(lastAccess[kv.first], kv.first);
+		}
+	}
+
+	for (const auto& chunkID : farChunks) {
+		residentBytes -= world.find(chunkID)->second->MemoryUsage();
+		EvictChunk(chunkID);
+	}
+
+	//Edits read back for chunks that never got generated are still on disk as they are
+	size_t editBytes = 0;
+	for (auto iter = edits.begin(); iter != edits.end();) {
+		glm::ivec2 offset = glm::abs(iter->first - playerChunk);
+		if (!world.contains(iter->first) && std::max(offset.x, offset.y) > evictDistance) {
+			iter = edits.erase(iter);
+		}
+		else {
+			editBytes += iter->second.MemoryUsage();
+			++iter;
+		}
+	}
+
+	//Requests dropped by the queue are made again if they come back in range, reading the region file again first
+	for (auto iter = requestedChunks.begin(); iter != requestedChunks.end();) {
+		glm::ivec2 offset = glm::abs(iter->first - playerChunk);
+		if (std::max(offset.x, offset.y) > evictDistance) {
+			iter = requestedChunks.erase(iter);
+		}
+		else {
+			++iter;
+		}
+	}
+
+	//Terrain is only kept until everything around it is decorated, or it's out of reach of the meshes. It's cheap to generate again
+	size_t terrainBytes = 0;
+	for (auto iter = terrainChunks.begin(); iter != terrainChunks.end();) {
+		glm::ivec2 offset = glm::abs(iter->first - playerChunk);
+		bool needed = std::max(offset.x, offset.y) <= RENDER_DISTANCE + 3
+			|| SquaredPathDistance(glm::vec2(iter->first), generationFocus, generationLookAhead) <= float((RENDER_DISTANCE + 3) * (RENDER_DISTANCE + 3));
+		if (needed) {
+			needed = false;
+			for (int i = 0; i < 9; i++) {
+				auto loaded = loadedChunks.find(glm::ivec2(i % 3 - 1, i / 3 - 1) + iter->first);
+				if (loaded == loadedChunks.end() || !loaded->second) {
+					needed = true;
+					break;
+				}
+			}
+		}
+
+		if (needed) {
+			terrainBytes += iter->second->MemoryUsage();
+			++iter;
+		}
+		else {
+			iter = terrainChunks.erase(iter);
+		}
+	}
+
+	if (residentBytes > settings.memoryBudget) {
+		//Least recently used first
+		std::sort(coldChunks.begin(), coldChunks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (const auto& [access, chunkID] : coldChunks) {
+			if (residentBytes <= settings.memoryBudget) break;
+			residentBytes -= world.find(chunkID)->second->MemoryUsage();
+			EvictChunk(chunkID);
+		}
+	}
+
+	//Close region files that are well out of reach
+	for (auto iter = regions.begin(); iter != regions.end();) {
+		glm::ivec2 offset = glm::abs(iter->first * REGION_SIZE + glm::ivec2(REGION_SIZE / 2) - playerChunk);
+		if (std::max(offset.x, offset.y) > evictDistance + REGION_SIZE) {
+			iter = regions.erase(iter);
+		}
+		else {
+			++iter;
+		}
+	}
+
+	float elapsed = time - lastEvictionTime;
+	stats.evictionsPerSecond = (stats.evictions - lastEvictions) / elapsed;
+	stats.reloadsPerSecond = (stats.reloads - lastReloads) / elapsed;
+	stats.residentChunks = world.size();
+	stats.residentBytes = residentBytes;
+	MemoryTracker::Set(MemoryCategory::ChunkData, int64_t(residentBytes + terrainBytes + editBytes), int64_t(world.size() + terrainChunks.size()));
+
+	lastEvictions = stats.evictions;
+	lastReloads = stats.reloads;
+	lastEvictionTime = time;
+}
+
+ChunkGenerator ChunkManager::WorldGenerator(const std::filesystem::path& directory, const ChunkGenerationSettings& settings) {
+	std::filesystem::create_directories(directory);
+	std::filesystem::path seedPath = directory / "seed.txt", generatorPath = directory / "generator.txt";
+
+	bool saved = false;
+	for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+		saved |= entry.path().extension() == ".region";
+	}
+
+	uint64_t seed = settings.seed;
+	bool seeded = false;
+	if (std::ifstream input{ seedPath }) {
+		if (!(input >> seed)) {
+			throw std::runtime_error("Failed to read the world seed from " + seedPath.string() + "!");
+		}
+		seeded = true;
+	}
+	else {
+		//Worlds saved before seeds existed were all made with the classic noise tables, seed 0. Only their noise is
+		//preserved, the biomes reshape the terrain, so new chunks will show seams against their saved ones
+		if (saved) {
+			seed = 0;
+		}
+		else if (seed == 0) {
+			std::random_device device;
+			seed = (uint64_t(device()) << 32) | device();
+		}
+
+		std::ofstream output{ seedPath };
+		if (!(output << seed)) {
+			throw std::runtime_error("Failed to write the world seed to " + seedPath.string() + "!");
+		}
+	}
+
+	uint32_t version = GENERATOR_VERSION;
+	TerrainSampling sampling = settings.sampling;
+	bool known = false;
+	if (std::ifstream input{ generatorPath }) {
+		if (!(input >> version >> sampling.detailStep >> sampling.heightStep >> sampling.sandStep)) {
+			throw std::runtime_error("Failed to read the world generator from " + generatorPath.string() + "!");
+		}
+		known = true;
+	}
+	else if (seeded && saved) {
+		//Saved as edits before the generator was written down, counted as version 1 with the default sampling, so
+		//they're refused rather than put on the biome terrain. Worlds from before seeds only have whole chunks
+		version = 1;
+		sampling = TerrainSampling{};
+	}
+
+	if (version != GENERATOR_VERSION) {
+		if (saved) {
+			throw std::runtime_error("The world in " + directory.string() + " was generated by generator version " + std::to_string(version)
+				+ ", its saved edits don't fit the terrain of version " + std::to_string(GENERATOR_VERSION) + "!");
+		}
+
+		//Nothing saved depends on the old terrain yet
+		version = GENERATOR_VERSION;
+		known = false;
+	}
+
+	if (!known) {
+		std::ofstream output{ generatorPath };
+		if (!(output << version << ' ' << sampling.detailStep << ' ' << sampling.heightStep << ' ' << sampling.sandStep)) {
+			throw std::runtime_error("Failed to write the world generator to " + generatorPath.string() + "!");
+		}
+	}
+
+	std::cout << "World seed: " << seed << std::endl;
+	return ChunkGenerator(seed, sampling);
+}
+
+RegionFile& ChunkManager::Region(const glm::ivec2& chunkID) {
+	//Round down to the region, REGION_SIZE is a power of two
+	glm::ivec2 regionID{ (chunkID.x & ~(REGION_SIZE - 1)) / REGION_SIZE, (chunkID.y & ~(REGION_SIZE - 1)) / REGION_SIZE };
+	auto region = regions.find(regionID);
+	if (region != regions.end()) return *region->second;
+
+	std::string name = "r." + std::to_string(regionID.x) + "." + std::to_string(regionID.y) + ".region";
+	return *(regions[regionID] = std::make_unique<RegionFile>(settings.directory / name));
+}
+
+void ChunkManager::UnloadMeshes(const glm::vec3& cameraPos) {
+	while (!retiredMeshes.empty() && retiredMeshes.front().first <= frameCount) {
+		retiredMeshes.pop_front();
+	}
+
+	//Same distance meshes are created within in Update
+	float renderDistance = float(RENDER_DISTANCE + 1) * CHUNK_SIZE;
+	float unloadDistance = float(RENDER_DISTANCE + 1 + std::max(meshSettings.unloadMargin, 0)) * CHUNK_SIZE;
+
+	std::vector<glm::ivec2> farMeshes;
+	std::vector<std::pair<float, glm::ivec2>> outsideMeshes;
+	for (const auto& kv : chunks) {
+		float dist = glm::distance(glm::vec3{ kv.first.x * CHUNK_SIZE, 0.f, kv.first.y * CHUNK_SIZE }, cameraPos * glm::vec3{ 1.f, 0.f, 1.f });
+		if (dist >= unloadDistance) {
+			farMeshes.push_back(kv.first);
+		}
+		else if (dist >= renderDistance) {
+			outsideMeshes.emplace_back(dist, kv.first);
+		}
+	}
+
+	auto retire = [this](const glm::ivec2& chunkID) {
+		auto mesh = chunks.find(chunkID);
+		retiredMeshes.emplace_back(frameCount + Swapchain::MAX_FRAMES_IN_FLIGHT, std::move(mesh->second));
+		chunks.erase(mesh);
+		unloadedMeshes++;
+	};
+
+	for (const auto& chunkID : farMeshes) {
+		retire(chunkID);
+	}
+
+	//Memory only goes down once the retired meshes are destroyed, so count it as already freed
+	VkDeviceSize bufferBytes = ChunkMesh::TotalBufferBytes();
+	size_t hostBytes = ChunkMesh::TotalHostBytes();
+	for (const auto& [frame, mesh] : retiredMeshes) {
+		bufferBytes -= mesh->BufferBytes();
+		hostBytes -= mesh->HostBytes();
+	}
+
+	if (bufferBytes > meshSettings.bufferBudget || hostBytes > meshSettings.hostBudget) {
+		//Furthest first
+		std::sort(outsideMeshes.begin(), outsideMeshes.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		for (const auto& [dist, chunkID] : outsideMeshes) {
+			if (bufferBytes <= meshSettings.bufferBudget && hostBytes <= meshSettings.hostBudget) break;
+			const ChunkMesh& mesh = *chunks.find(chunkID)->second;
+			bufferBytes -= mesh.BufferBytes();
+			hostBytes -= mesh.HostBytes();
+			retire(chunkID);
+		}
+	}
+}
+
+void ChunkManager::CountMissingMeshes(const glm::vec3& cameraPos, const glm::vec3& forward) {
+	glm::vec2 camera = glm::vec2(cameraPos.x, cameraPos.z) / float(CHUNK_SIZE);
+	glm::vec2 heading{ forward.x, forward.z };
+
+	uint64_t visible = 0, missing = 0;
+	for (const auto& chunkID : sortedChunks) {
+		//Roughly what's on screen, in range and not behind the camera
+		glm::vec2 offset = glm::vec2(chunkID) - camera;
+		float dist = glm::length(offset);
+		if (dist >= RENDER_DISTANCE || (dist > 1.5f && glm::dot(offset, heading) < 0.f)) continue;
+
+		visible++;
+		if (!chunks[chunkID]->Loaded()) missing++;
+	}
+
+	drawStats.frames++;
+	drawStats.framesWithHoles += missing > 0;
+	drawStats.visibleChunks += visible;
+	drawStats.missingChunks += missing;
+}
+
+ChunkMeshStats ChunkManager::MeshStats() const {
+	ChunkMeshStats meshStats;
+	meshStats.liveMeshes = ChunkMesh::LiveMeshes();
+	meshStats.bufferBytes = ChunkMesh::TotalBufferBytes();
+	meshStats.hostBytes = ChunkMesh::TotalHostBytes();
+	meshStats.unloaded = unloadedMeshes;
+	return meshStats;
+}
+
+uint32_t ChunkManager::MaxBlockHeight(const glm::ivec2& chunk) const {
+	auto chunkData = world.find(chunk);
+	if (chunkData == world.end()) return 0;
+
+	return std::max(chunkData->second->MaxHeight(), 1u);
+}
+
+std::shared_ptr<const Chunk> ChunkManager::Snapshot(const glm::ivec2& chunkID) const {
+	auto chunk = world.find(chunkID);
+	if (chunk == world.end()) return nullptr;
+	return chunk->second;
+}
+
+ChunkNeighborhood ChunkManager::Neighborhood(const glm::ivec2& chunkID) const {
+	std::array<std::shared_ptr<const Chunk>, 9> chunks;
+	for (int i = 0; i < 9; i++) {
+		chunks[i] = Snapshot(chunkID + glm::ivec2(i % 3 - 1, i / 3 - 1));
+	}
+	return ChunkNeighborhood(chunkID, chunks);
 }
\ No newline at end of file
@@ -3,11 +3,87 @@
 #include "Core\Device.h"
 #include "Core\Events.h"
 #include "ChunkMesh.h"
+#include "ChunkNeighborhood.h"
 #include "Block.h"
-#include "Noise\Noise.h"
+#include "RegionFile.h"
+#include "ChunkEdits.h"
+#include "GenerationQueue.h"
+#include "Util\ChunkMap.h"
 
 constexpr int RENDER_DISTANCE = 12;
 constexpr int MAX_SORTED_CHUNKS = 4;
+//How often (in seconds) cold chunks are looked for and the storage stats are updated
+constexpr float EVICTION_INTERVAL = 1.f;
+//Region file flag for chunks that have been generated. Older saves also have chunks without it, that only had
+//leaves from their neighbors written into them, those are generated over
+constexpr uint32_t CHUNK_GENERATED = 1;
+//Region file flag for chunks saved as just the player's edits (see ChunkEdits) instead of all of their blocks.
+//Chunks nobody has edited aren't saved at all, they're generated again from the seed
+constexpr uint32_t CHUNK_EDITS = 2;
+
+struct ChunkStorageSettings {
+	std::filesystem::path directory = "World";
+	//Chunks further than this (in chunks) from the player are written out to their region file.
+	//Never less than RENDER_DISTANCE + 2, everything inside of that is needed for meshing
+	int evictDistance = RENDER_DISTANCE + 8;
+	//Past this, the least recently used chunks outside of the render distance are evicted as well
+	size_t memoryBudget = 256ull * 1024 * 1024;
+	//Back the block storage slabs with transparent huge pages, Linux only
+	bool hugePages = true;
+};
+
+struct ChunkMeshSettings {
+	//Meshes are made within RENDER_DISTANCE + 1 chunks of the player and destroyed past this many more,
+	//so moving back and forth over the edge doesn't keep rebuilding them
+	int unloadMargin = 4;
+	//Past either of these, meshes outside of the render distance are destroyed furthest first
+	VkDeviceSize bufferBudget = 512ull * 1024 * 1024;
+	size_t hostBudget = 16ull * 1024 * 1024;
+	//Merge neighboring faces of the same block into larger quads (see BuildChunkMesh)
+	bool greedy = true;
+};
+
+struct ChunkGenerationSettings {
+	//Seed of new worlds, 0 picks a random one. The seed of a world is kept in its directory (seed.txt), so it
+	//regenerates the same whatever this is set to on later runs
+	uint64_t seed = 0;
+	//TerrainSampling::Coarse() cuts the noise evaluations per chunk about tenfold, at the cost of smoother hills.
+	//Only used for new worlds. Saved chunks are regenerated under their edits, so a world keeps the sampling it was
+	//made with (generator.txt) whatever this is set to on later runs
+	TerrainSampling sampling;
+	//Worker threads generating chunks, 0 uses all but one of the cores
+	unsigned threads = 0;
+	//Queued chunks further than this (in chunks) from the camera are dropped, they're requested again if they come back in range
+	int dropDistance = RENDER_DISTANCE + 4;
+	//Seconds of travel ahead of the camera. Chunks along the way are generated and meshed first, and the ones in range
+	//of where it's headed are generated before it gets there. Capped to stay inside the evict distance, 0 turns it off
+	float lookAhead = 2.f;
+};
+
+struct ChunkMeshStats {
+	size_t liveMeshes = 0;
+	VkDeviceSize bufferBytes = 0;
+	size_t hostBytes = 0;
+	uint64_t unloaded = 0;
+};
+
+//Chunks in range and in front of the camera when they're drawn, and how many of them had no mesh yet
+struct ChunkDrawStats {
+	uint64_t frames = 0;
+	uint64_t framesWithHoles = 0;
+	uint64_t visibleChunks = 0;
+	uint64_t missingChunks = 0;
+};
+
+struct ChunkStorageStats {
+	uint64_t evictions = 0;
+	uint64_t reloads = 0;
+	//Over the last EVICTION_INTERVAL
+	float evictionsPerSecond = 0.f;
+	float reloadsPerSecond = 0.f;
+	size_t residentChunks = 0;
+	size_t residentBytes = 0;
+};
 
 struct BlockHitInfo {
 	glm::ivec2 chunkID;
@@ -23,7 +99,9 @@ inline glm::ivec3 BlockToChunk(const glm::ivec3& block, glm::ivec2& chunk);
 
 class ChunkManager {
 public:
-	ChunkManager(Device& device);
+	ChunkManager(Device& device, const ChunkStorageSettings& settings = ChunkStorageSettings{}, const ChunkMeshSettings& meshSettings = ChunkMeshSettings{},
+		const ChunkGenerationSettings& generationSettings = ChunkGenerationSettings{});
+	~ChunkManager();
 
 	void Update(const UpdateEvent& event);
 
@@ -31,26 +109,104 @@ public:
 	void BreakBlock(const glm::ivec3& pos, const UpdateEvent& event);
 	void PlaceBlock(const glm::ivec3& pos, BlockID block, const UpdateEvent& event);
 
-	inline BlockID BlockAt(const glm::ivec3& pos);
+	//Air if the chunk isn't loaded, reading never generates anything
+	inline BlockID BlockAt(const glm::ivec3& pos) const;
 	inline uint32_t NumBlocks(const glm::ivec2& chunk) const;
 	uint32_t MaxBlockHeight(const glm::ivec2& chunk) const;
 
-private:
-	void GenerateChunk(const glm::ivec2& chunkID);
+	//The current version of the chunk, null if it isn't loaded. It never changes, edits made after
+	//this copy the chunk first, so it can be handed to other threads. Only call on the main thread
+	std::shared_ptr<const Chunk> Snapshot(const glm::ivec2& chunkID) const;
+	//Snapshots of the chunk and its 8 neighbors, for meshing. Only call on the main thread
+	ChunkNeighborhood Neighborhood(const glm::ivec2& chunkID) const;
 
-	//TODO: offload to a file when full
-	std::unordered_map<glm::ivec2, std::array<BlockID, CHUNK_SIZE * CHUNK_SIZE * MAX_BLOCK_HEIGHT>> world;
-	std::unordered_map<glm::ivec2, bool> loadedChunks;
+	const ChunkStorageStats& StorageStats() const { return stats; }
+	ChunkMeshStats MeshStats() const;
+	const ChunkMeshSettings& MeshSettings() const { return meshSettings; }
+	//The index buffer every chunk mesh is drawn with, see QuadIndices
+	const Buffer& QuadIndexBuffer() const { return *quadIndices; }
+	const ChunkDrawStats& DrawStats() const { return drawStats; }
 
-	//TOOD: because these don't actually have world data, if these get far enough from the player,
-	//they could be destroyed to conserve memory
+	//In blocks per second, where the look ahead goes by
+	void SetPlayerVelocity(const glm::vec3& velocity) { playerVelocity = velocity; }
+	//Called when the chunks are drawn, adds the frame to the draw stats
+	void CountMissingMeshes(const glm::vec3& cameraPos, const glm::vec3& forward);
+
+private:
+	//True once the chunk has been generated or read back generated from its region file. Never generates it
+	bool IsGenerated(const glm::ivec2& chunkID);
+	//Queues decoration for the chunks whose neighbors all have terrain, and terrain for the neighbors that don't
+	void RequestChunks(std::vector<glm::ivec2>& chunkIDs);
+	//Moves the chunks the generation workers finished into the world
+	void PublishChunks();
+	//Where the camera will be in generationSettings.lookAhead seconds, relative to where it is now, in chunks
+	glm::vec2 LookAhead() const;
+	//The chunk's data, ready to be written to. Read back from its region file if it was evicted, doesn't generate it
+	Chunk& GetChunk(const glm::ivec2& chunkID);
+	//Copy on write, so readers holding a snapshot keep the version they took
+	static Chunk& Writable(std::shared_ptr<Chunk>& chunk);
+	bool LoadChunk(const glm::ivec2& chunkID);
+	void EvictChunk(const glm::ivec2& chunkID);
+	//The generator of the world in the directory, made from the seed (seed.txt) and the generator version and sampling
+	//(generator.txt) saved there. A new world saves the ones in the settings first. Throws if the saved chunks were
+	//made by another generator version, their edits would be put on different terrain
+	static ChunkGenerator WorldGenerator(const std::filesystem::path& directory, const ChunkGenerationSettings& settings);
+	void EvictChunks(const glm::ivec2& playerChunk, float time);
+	RegionFile& Region(const glm::ivec2& chunkID);
+	void UnloadMeshes(const glm::vec3& cameraPos);
+	//Sets the block and records it in the chunk's edits
+	void SetBlock(const glm::ivec2& chunkID, const glm::ivec3& blockPos, BlockID block);
+	//Flag the chunk's mesh to be rebuilt if it has one, right away if an event is given
+	void InvalidateMesh(const glm::ivec2& chunkID, const UpdateEvent* event = nullptr);
+
+	//Only chunks near the player are kept here, the rest are in region files.
+	//Only touched from the main thread, other threads get snapshots
+	ChunkMap<std::shared_ptr<Chunk>> world;
+	ChunkMap<bool> loadedChunks;
+	//Neither in the world nor in their region file when they were first needed, so they were sent to the generator.
+	//Their region file isn't read again until they're published, evicted or out of reach
+	ChunkMap<bool> requestedChunks;
+	//Changed since they were last written to their region file
+	ChunkMap<bool> unsavedChunks;
+	//Player edits of the resident chunks, and of the chunks whose edits were read back but that are still being generated
+	ChunkMap<ChunkEdits> edits;
+	//Read back whole from saves made before edits were kept apart, so they're written back whole as well
+	ChunkMap<bool> wholeChunks;
+	ChunkMap<float> lastAccess;
+	ChunkMap<std::unique_ptr<RegionFile>> regions;
+	ChunkStorageSettings settings;
+	ChunkStorageStats stats;
+	uint64_t lastEvictions = 0, lastReloads = 0;
+	float lastEvictionTime = 0.f, currentTime = 0.f;
+	std::vector<uint8_t> chunkBuffer;
+
+	//Before the meshes so it outlives them
+	std::unique_ptr<Buffer> quadIndices;
+	ChunkMap<std::unique_ptr<ChunkMesh>> chunks;
+	//Unloaded meshes, kept until the frame they can be destroyed on since frames in flight may still draw them
+	std::deque<std::pair<uint64_t, std::unique_ptr<ChunkMesh>>> retiredMeshes;
+	ChunkMeshSettings meshSettings;
+	uint64_t frameCount = 0, unloadedMeshes = 0;
 	//Ordered by distance from the camera
-	std::unordered_map<glm::ivec2, std::unique_ptr<ChunkMesh>> chunks;
 	std::vector<glm::ivec2> sortedChunks;
+	//Ordered by distance from the way the camera is heading, the order meshes are made in
+	std::vector<glm::ivec2> meshOrder;
+	ChunkDrawStats drawStats;
 	glm::ivec2 oldPlayerChunk;
 	glm::ivec3 oldPlayerPos;
 	Device& device;
-	SimplexNoise height{ 0.006f, 10.f, 2.1f, 0.45f }, detail{ 1.f, 1.f, 1.8f, 0.6f }, sand{ 0.006f, 1.f };
+
+	//The queue's workers use the generator, so it has to go first
+	ChunkGenerator generator;
+	GenerationQueue generationQueue;
+	ChunkGenerationSettings generationSettings;
+	//Undecorated terrain, what decorating the chunks next to it reads
+	ChunkMap<std::shared_ptr<const Chunk>> terrainChunks;
+	std::vector<glm::ivec2> missingChunks, missingTerrain;
+	std::vector<std::pair<glm::ivec2, TerrainNeighborhood>> decorations;
+	std::vector<GeneratedChunk> generatedChunks;
+	glm::vec2 generationFocus{ 0.f }, generationLookAhead{ 0.f };
+	glm::vec3 playerVelocity{ 0.f };
 	friend class ChunkRenderer;
 };
 
@@ -70,28 +226,21 @@ inline glm::ivec3 BlockToChunk(const glm::ivec3& block, glm::ivec2& chunk) {
 	return blockPos;
 }
 
-inline BlockID ChunkManager::BlockAt(const glm::ivec3& pos) {
+inline BlockID ChunkManager::BlockAt(const glm::ivec3& pos) const {
 	if (pos.y < 0 || pos.y >= MAX_BLOCK_HEIGHT) return 0;
 
 	glm::ivec2 chunkID;
 	glm::ivec3 blockPos = BlockToChunk(pos, chunkID);
 
-	if (!world.contains(chunkID)) {
-		GenerateChunk(chunkID);
-		return BlockAt(pos);
-	}
+	auto chunk = world.find(chunkID);
+	if (chunk == world.end()) return 0;
 
-	return world[chunkID][blockPos.y * CHUNK_SIZE * CHUNK_SIZE + blockPos.z * CHUNK_SIZE + blockPos.x];
+	return chunk->second->Get(blockPos.x, blockPos.y, blockPos.z);
 }
 
 inline uint32_t ChunkManager::NumBlocks(const glm::ivec2& chunk) const {
-	if (!world.contains(chunk)) return 0;
-
-	uint32_t num = 0;
-	auto& chunkData = world.find(chunk)->second;
-	for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE * MAX_BLOCK_HEIGHT; i++) {
-		if (chunkData[i] > 0) num++;
-	}
+	auto chunkData = world.find(chunk);
+	if (chunkData == world.end()) return 0;
 
-	return num;
+	return chunkData->second->NumBlocks();
 }
\ No newline at end of file
@@ -2,13 +2,9 @@
 
 #include "Core\Buffer.h"
 #include "Core\Events.h"
-
-constexpr int CHUNK_SIZE = 16;
-constexpr int MAX_BLOCK_HEIGHT = 256;
-
-using BlockID = unsigned char;
-
-extern const std::vector<struct Block> blocks;
+#include "ChunkData.h"
+#include "Block.h"
+#include "ChunkMesher.h"
 
 class ChunkMesh {
 public:
@@ -28,13 +24,32 @@ public:
 	//Resort transparent geometry
 	void Resort(const UpdateEvent& event);
 
-	struct Triangle {
-		uint32_t indices[6];
+	struct Quad {
+		ChunkVertex corners[4];
 	};
 
+	//Size of the vertex buffers this mesh holds, for every frame in flight
+	VkDeviceSize BufferBytes() const;
+	//CPU side memory of the mesh object and its buffer handles
+	size_t HostBytes() const;
+
+	//Totals over every ChunkMesh that is alive, including unloaded ones waiting on frames in flight
+	static size_t LiveMeshes() { return liveMeshes; }
+	static VkDeviceSize TotalBufferBytes() { return totalBufferBytes; }
+	static size_t TotalHostBytes() { return totalHostBytes; }
+
 private:
+	//Add (sign = 1) or remove (sign = -1) this mesh from the totals
+	void Track(int sign);
+	//Draws quadCount quads from the vertices at offset with the manager's quad indices
+	void DrawQuads(const RenderEvent& event, VkDeviceSize offset, uint32_t quadCount);
+
+	inline static size_t liveMeshes = 0;
+	inline static VkDeviceSize totalBufferBytes = 0;
+	inline static size_t totalHostBytes = 0;
+
 	std::vector<std::unique_ptr<Buffer>> meshData;
-	VkDeviceSize indexOffset, transparentVertexOffset, transparentIndexOffset;
+	VkDeviceSize transparentVertexOffset;
 
 	uint32_t mostRecentMesh;
 	glm::ivec2 pos;
@@ -0,0 +1,362 @@
+#include "ChunkMesher.h"
+
+#include <algorithm>
+#include <bit>
+
+const std::vector<Block> blocks = {
+	{ "Grass", { { 2.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 0.f, 0.f }, { 0.f, 0.f }, { 0.f, 0.f }, { 0.f, 0.f } } },
+	{ "Dirt", { { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 0.f } } },
+	{ "Stone", { { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 0.f } } },
+	{ "Water", { { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 3.f / (float)TEXTURE_ATLAS_SIZE, 0.f } }, Block::Flags(Block::TRANSPARENT | Block::LIQUID) },
+	{ "Log", { { 6.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 6.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 7.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 7.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 7.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 7.f / (float)TEXTURE_ATLAS_SIZE, 0.f } } },
+	{ "Leaves", { { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 0.f, 1.f / (float)TEXTURE_ATLAS_SIZE } }, Block::HOLES },
+	{ "Sand", { { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 0.f } } },
+	{ "Planks", { { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 4.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE } } },
+	{ "Cobblestone", { { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 5.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE } } },
+	{ "Glass", { { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE }, { 1.f / (float)TEXTURE_ATLAS_SIZE, 1.f / (float)TEXTURE_ATLAS_SIZE } }, Block::TRANSPARENT }
+};
+
+//Block mesh constants
+const std::vector<glm::vec3> blockCorners = {
+	{ 0.f, 0.f, 0.f },
+	{ 1.f, 0.f, 0.f },
+	{ 0.f, 1.f, 0.f },
+	{ 0.f, 0.f, 1.f },
+	{ 1.f, 1.f, 0.f },
+	{ 0.f, 1.f, 1.f },
+	{ 1.f, 0.f, 1.f },
+	{ 1.f, 1.f, 1.f }
+};
+
+const std::vector<glm::vec3> blockNormals = {
+	{ 0.f, 1.f, 0.f },
+	{ 0.f, -1.f, 0.f },
+	{ 1.f, 0.f, 0.f },
+	{ -1.f, 0.f, 0.f },
+	{ 0.f, 0.f, 1.f },
+	{ 0.f, 0.f, -1.f }
+};
+
+const std::vector<uint32_t> blockIndices = {
+	2, 5, 7, 4, //Top
+	1, 6, 3, 0, //Bottom
+	1, 4, 7, 6, //Right
+	3, 5, 2, 0, //Left
+	6, 7, 5, 3, //Front
+	0, 2, 4, 1 //Back
+};
+
+const std::vector<uint16_t> indices = {
+	0, 1, 2, 2, 3, 0
+};
+
+//The axis each face looks along, and the axes its texture's u and v go along
+constexpr int faceAxes[6] = { 1, 1, 0, 0, 2, 2 };
+constexpr int faceUvAxes[6][2] = { { 0, 2 }, { 0, 2 }, { 2, 1 }, { 2, 1 }, { 0, 1 }, { 0, 1 } };
+
+//The column next to each side, in x and z
+constexpr int sideColumns[6][2] = { { 0, 0 }, { 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+//Faces are the block's ID, or'd with this when the block next to it has holes
+constexpr uint16_t FACE_AGAINST_HOLES = 1 << 8;
+
+//Copies the columns [x, x + width) x [z, z + depth) of the chunk up to the height. The chunk is dx, dz chunks from the center
+static void CopyColumns(std::vector<BlockID>& volume, const Chunk& chunk, int dx, int dz, int x, int z, int width, int depth, int height) {
+	for (int section = 0; section * SECTION_HEIGHT < height; section++) {
+		const BlockStorage& storage = chunk.Section(section);
+		int top = std::min(height, (section + 1) * SECTION_HEIGHT);
+		for (int y = section * SECTION_HEIGHT; y < top; y++) {
+			for (int bz = z; bz < z + depth; bz++) {
+				BlockID* row = &volume[PaddedChunk::Index(x + dx * CHUNK_SIZE, y, bz + dz * CHUNK_SIZE)];
+				if (storage.IsUniform()) {
+					std::fill_n(row, width, storage.UniformBlock());
+					continue;
+				}
+
+				uint32_t index = BlockIndex(x, y, bz) % SECTION_VOLUME;
+				for (int bx = 0; bx < width; bx++) {
+					row[bx] = storage.Get(index + bx);
+				}
+			}
+		}
+	}
+}
+
+void PaddedChunk::Copy(const ChunkNeighborhood& neighborhood) {
+	height = neighborhood.MaxHeight();
+	volume.assign(size_t(height + 2) * PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE, 0);
+	for (int section = 0; section < SECTIONS_PER_CHUNK; section++) {
+		hidden[section] = section * SECTION_HEIGHT >= height || neighborhood.IsSectionHidden(section);
+	}
+
+	for (int dz = -1; dz <= 1; dz++) {
+		for (int dx = -1; dx <= 1; dx++) {
+			const auto& chunk = neighborhood.Neighbor(dx, dz);
+			if (!chunk) continue;
+
+			//All of the center, only the edge next to it of the neighbors
+			int x = dx < 0 ? CHUNK_SIZE - 1 : 0, width = dx == 0 ? CHUNK_SIZE : 1;
+			int z = dz < 0 ? CHUNK_SIZE - 1 : 0, depth = dz == 0 ? CHUNK_SIZE : 1;
+			CopyColumns(volume, *chunk, dx, dz, x, z, width, depth, std::min(height, (int)chunk->MaxHeight()));
+		}
+	}
+}
+
+ChunkVertex ChunkVertex::Pack(const glm::ivec3& corner, int side, int tile, uint32_t flags) {
+	return ChunkVertex{ uint32_t(corner.x) | uint32_t(corner.y) << Y_SHIFT | uint32_t(corner.z) << Z_SHIFT
+		| uint32_t(side) << SIDE_SHIFT | uint32_t(tile) << TILE_SHIFT | flags };
+}
+
+glm::vec3 ChunkVertex::Position() const {
+	glm::vec3 pos = glm::vec3(Corner());
+	if (data & LOWERED) pos.y -= 0.0625f;
+	if (data & INSET) pos -= blockNormals[Side()] * 0.001f;
+	return pos;
+}
+
+void ChunkGeometry::Clear() {
+	vertices.clear();
+	transparentVertices.clear();
+}
+
+//The seen faces on one side of the chunk, in slices along the axis the side looks along. A slice is made of rows of
+//CHUNK_SIZE faces along the texture's u axis (x or z for every side), and each row has a bitmask of the faces in it.
+//Faces are only valid where their bit is set, so the faces don't have to be cleared between sides
+struct FaceSlices {
+	int d, u, v;
+	int rowsPerSlice;
+	std::vector<uint16_t> faces;
+	std::vector<uint16_t> rowBits;
+
+	int Row(const glm::ivec3& pos) const { return pos[d] * rowsPerSlice + pos[v]; }
+};
+
+//Bitmasks of the blocks in every column of a PaddedChunk, bit y + 1 of a column is the block at y. Whether the faces
+//on a side are seen is worked out for 64 blocks of a column at a time, against the same column shifted up or down
+//for the top and bottom, and against the next column over for the rest
+class ColumnMasks {
+public:
+	ColumnMasks(const PaddedChunk& chunk);
+
+	//Adds the seen faces on side s to the slices
+	void FindFaces(const PaddedChunk& chunk, int s, FaceSlices& slices) const;
+
+private:
+	//What a block is for culling
+	enum Flags : uint8_t {
+		SOLID = 1 << 0,
+		HOLES = 1 << 1,
+		TRANSPARENT = 1 << 2
+	};
+	struct BlockMasks {
+		std::array<uint8_t, 256> flags{};
+		//Transparent blocks hide each other's faces only if they're the same block, so each has its own masks
+		std::array<int8_t, 256> transparentSlots;
+		int transparentCount = 0;
+	};
+	static const BlockMasks& Blocks();
+
+	//Where the words of the column start
+	size_t Column(int x, int z) const { return size_t((z + 1) * PADDED_CHUNK_SIZE + x + 1) * columnWords; }
+
+	int columnWords;
+	//Solid blocks are anything but air
+	std::vector<uint64_t> solid, holes, transparent;
+	//One set of columns after the other, for each transparent block
+	std::vector<uint64_t> transparentBlocks;
+	//The rows of the center chunk that can have faces, below its height and out of hidden sections
+	std::vector<uint64_t> rows;
+};
+
+const ColumnMasks::BlockMasks& ColumnMasks::Blocks() {
+	static const BlockMasks masks = [] {
+		BlockMasks masks;
+		masks.transparentSlots.fill(-1);
+		for (size_t i = 0; i < blocks.size(); i++) {
+			BlockID block = BlockID(i + 1);
+			masks.flags[block] = SOLID;
+			if (blocks[i].flags & Block::HOLES) masks.flags[block] |= HOLES;
+			if (blocks[i].flags & Block::TRANSPARENT) {
+				masks.flags[block] |= TRANSPARENT;
+				masks.transparentSlots[block] = int8_t(masks.transparentCount++);
+			}
+		}
+		return masks;
+	}();
+	return masks;
+}
+
+ColumnMasks::ColumnMasks(const PaddedChunk& chunk) {
+	const BlockMasks& blockMasks = Blocks();
+	const int layers = chunk.Height() + 2;
+	columnWords = (layers + 63) / 64;
+
+	const size_t words = size_t(PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE) * columnWords;
+	solid.resize(words);
+	holes.resize(words);
+	transparent.resize(words);
+	transparentBlocks.assign(words * blockMasks.transparentCount, 0);
+
+	//A column at a time, so the words are built up in registers
+	const BlockID* volume = chunk.Data();
+	for (int column = 0; column < PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE; column++) {
+		for (int word = 0; word < columnWords; word++) {
+			uint64_t solidWord = 0, holesWord = 0, transparentWord = 0;
+			for (int layer = word * 64; layer < std::min(layers, (word + 1) * 64); layer++) {
+				BlockID block = volume[layer * PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE + column];
+				uint64_t flags = blockMasks.flags[block];
+				int bit = layer % 64;
+				solidWord |= (flags & SOLID) << bit;
+				holesWord |= ((flags & HOLES) >> 1) << bit;
+				if (flags & TRANSPARENT) {
+					transparentWord |= 1ull << bit;
+					transparentBlocks[blockMasks.transparentSlots[block] * words + column * columnWords + word] |= 1ull << bit;
+				}
+			}
+
+			size_t index = column * columnWords + word;
+			solid[index] = solidWord;
+			holes[index] = holesWord;
+			transparent[index] = transparentWord;
+		}
+	}
+
+	rows.assign(columnWords, 0);
+	for (int y = 0; y < chunk.Height(); y++) {
+		if (!chunk.IsSectionHidden(y / SECTION_HEIGHT)) rows[(y + 1) / 64] |= 1ull << ((y + 1) % 64);
+	}
+}
+
+void ColumnMasks::FindFaces(const PaddedChunk& chunk, int s, FaceSlices& slices) const {
+	const int transparentCount = Blocks().transparentCount;
+	const size_t words = solid.size();
+	const int dx = sideColumns[s][0], dz = sideColumns[s][1];
+
+	//The masks of the blocks on side s of the ones in word w of the column, shifted in from the words next to it for the top and bottom
+	auto side = [&](const uint64_t* column, int w) {
+		if (s == 0) return (column[w] >> 1) | (w + 1 < columnWords ? column[w + 1] << 63 : 0);
+		if (s == 1) return (column[w] << 1) | (w > 0 ? column[w - 1] >> 63 : 0);
+		return column[w];
+	};
+
+	for (int z = 0; z < CHUNK_SIZE; z++) {
+		for (int x = 0; x < CHUNK_SIZE; x++) {
+			const size_t column = Column(x, z), sideColumn = Column(x + dx, z + dz);
+
+			for (int w = 0; w < columnWords; w++) {
+				uint64_t blocks = solid[column + w] & rows[w];
+				if (blocks == 0) continue;
+
+				//Transparent blocks next to the same transparent block
+				uint64_t same = 0;
+				for (int slot = 0; slot < transparentCount; slot++) {
+					const uint64_t* masks = &transparentBlocks[slot * words];
+					same |= masks[column + w] & side(masks + sideColumn, w);
+				}
+
+				uint64_t againstHoles = side(&holes[sideColumn], w);
+				uint64_t seen = blocks & (~side(&solid[sideColumn], w) | againstHoles | (side(&transparent[sideColumn], w) & ~same));
+				while (seen) {
+					int bit = std::countr_zero(seen);
+					seen &= seen - 1;
+
+					int y = w * 64 + bit - 1;
+					uint16_t face = chunk.At(x, y, z);
+					if (againstHoles & (1ull << bit)) face |= FACE_AGAINST_HOLES;
+					glm::ivec3 pos(x, y, z);
+					int row = slices.Row(pos);
+					slices.faces[row * CHUNK_SIZE + pos[slices.u]] = face;
+					slices.rowBits[row] |= uint16_t(1u << pos[slices.u]);
+				}
+			}
+		}
+	}
+}
+
+//A quad of size faces on side s, starting from the block at pos. The size is 1 along the face's axis
+static void AddFace(ChunkGeometry& geometry, const glm::ivec3& pos, const glm::ivec3& size, int s, uint16_t face) {
+	const Block& block = blocks[(face & 0xff) - 1];
+	bool transparent = block.flags & Block::TRANSPARENT;
+	std::vector<ChunkVertex>& vertices = transparent ? geometry.transparentVertices : geometry.vertices;
+
+	const glm::vec2 offset = block.textureOffsets[s] * (float)TEXTURE_ATLAS_SIZE;
+	const int tile = int(offset.x + 0.5f) + int(offset.y + 0.5f) * TEXTURE_ATLAS_SIZE;
+	for (int j = 0; j < 4; j++) {
+		glm::ivec3 corner = glm::ivec3(blockCorners[blockIndices[s * 4 + j]]);
+		uint32_t flags = 0;
+		if ((block.flags & Block::LIQUID) && corner.y == 1) flags |= ChunkVertex::LOWERED;
+		//Fix transparent blocks on holed blocks
+		if (transparent && (face & FACE_AGAINST_HOLES)) flags |= ChunkVertex::INSET;
+
+		vertices.emplace_back(ChunkVertex::Pack(pos + corner * size, s, tile, flags));
+	}
+}
+
+void BuildChunkMesh(const PaddedChunk& chunk, bool greedy, ChunkGeometry& geometry) {
+	geometry.Clear();
+
+	const int height = chunk.Height();
+	//Each side is meshed one slice of the chunk at a time. Every side has CHUNK_SIZE x height rows
+	const glm::ivec3 dims(CHUNK_SIZE, height, CHUNK_SIZE);
+	ColumnMasks masks(chunk);
+	FaceSlices slices;
+	slices.faces.resize(size_t(CHUNK_SIZE) * CHUNK_SIZE * height);
+	slices.rowBits.assign(size_t(CHUNK_SIZE) * height, 0);
+	for (int s = 0; s < 6; s++) {
+		slices.d = faceAxes[s];
+		slices.u = faceUvAxes[s][0];
+		slices.v = faceUvAxes[s][1];
+		slices.rowsPerSlice = dims[slices.v];
+		masks.FindFaces(chunk, s, slices);
+
+		//Every face is taken out of the row bits as it's added, so they're clear again for the next side
+		for (int slice = 0; slice < dims[slices.d]; slice++) {
+			for (int b = 0; b < slices.rowsPerSlice; b++) {
+				const int row = slice * slices.rowsPerSlice + b;
+				while (slices.rowBits[row]) {
+					int a = std::countr_zero(slices.rowBits[row]);
+					const uint16_t* faces = &slices.faces[row * CHUNK_SIZE];
+					uint16_t face = faces[a];
+
+					//Grow the quad along u while the faces match, then along v while the whole row does
+					int width = 1, rows = 1;
+					if (greedy) {
+						while (a + width < CHUNK_SIZE && (slices.rowBits[row] >> (a + width) & 1) && faces[a + width] == face) width++;
+						const uint16_t span = uint16_t(((1u << width) - 1) << a);
+						for (; b + rows < slices.rowsPerSlice; rows++) {
+							const int next = row + rows;
+							if ((slices.rowBits[next] & span) != span) break;
+							const uint16_t* nextFaces = &slices.faces[next * CHUNK_SIZE + a];
+							if (!std::all_of(nextFaces, nextFaces + width, [face](uint16_t other) { return other == face; })) break;
+						}
+						for (int r = 0; r < rows; r++) {
+							slices.rowBits[row + r] &= ~span;
+						}
+					}
+					else {
+						slices.rowBits[row] &= ~uint16_t(1u << a);
+					}
+
+					glm::ivec3 start, size(1);
+					start[slices.d] = slice;
+					start[slices.u] = a;
+					start[slices.v] = b;
+					size[slices.u] = width;
+					size[slices.v] = rows;
+					AddFace(geometry, start, size, s, face);
+				}
+			}
+		}
+	}
+}
+
+std::vector<uint16_t> QuadIndices() {
+	std::vector<uint16_t> quadIndices;
+	quadIndices.reserve(MAX_QUADS_PER_DRAW * indices.size());
+	for (uint32_t quad = 0; quad < MAX_QUADS_PER_DRAW; quad++) {
+		for (uint16_t index : indices) {
+			quadIndices.push_back(uint16_t(quad * 4 + index));
+		}
+	}
+	return quadIndices;
+}
\ No newline at end of file
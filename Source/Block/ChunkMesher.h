@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ChunkNeighborhood.h"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+constexpr int TEXTURE_ATLAS_SIZE = 8; //Tiles across the texture atlas
+constexpr int PADDED_CHUNK_SIZE = CHUNK_SIZE + 2;
+
+//A corner of a chunk mesh face packed into 32 bits: its block corner in the chunk, the side of the block the face is on,
+//the atlas tile and two flags that nudge it off the corner. chunk.vert and shadow.vert work out the rest from those (the
+//normal, the shade of the side and the uv, in blocks across the face so merged faces repeat the tile once per block),
+//so they have to be kept in step with the bits here
+struct ChunkVertex {
+	uint32_t data;
+
+	//x and z are 5 bits, y is 9, so a corner can be on the far side of the chunk or the top of the world
+	static constexpr uint32_t Y_SHIFT = 5, Z_SHIFT = 14, SIDE_SHIFT = 19, TILE_SHIFT = 24;
+	//Liquid surfaces are a little under the top of the block
+	static constexpr uint32_t LOWERED = 1u << 22;
+	//Transparent faces against blocks with holes are pulled back a little, so they don't fight over the same depth
+	static constexpr uint32_t INSET = 1u << 23;
+
+	//The tile is x + y * TEXTURE_ATLAS_SIZE
+	static ChunkVertex Pack(const glm::ivec3& corner, int side, int tile, uint32_t flags);
+	glm::ivec3 Corner() const { return glm::ivec3(data & 31u, (data >> Y_SHIFT) & 511u, (data >> Z_SHIFT) & 31u); }
+	int Side() const { return (data >> SIDE_SHIFT) & 7u; }
+	//Where the corner ends up, like chunk.vert puts it
+	glm::vec3 Position() const;
+};
+static_assert(sizeof(ChunkVertex) == 4);
+
+//What a chunk mesh's buffers are filled with. Transparent faces are kept apart so they can be drawn after, and sorted.
+//Every 4 vertices are one quad, there are no indices, the quads are drawn with the shared indices from QuadIndices
+struct ChunkGeometry {
+	std::vector<ChunkVertex> vertices, transparentVertices;
+
+	void Clear();
+};
+
+//What the mesher reads: the center chunk of a neighborhood and the one block wide border of its neighbors that the
+//faces on its edges look at, copied into one flat array so looking up a block is just indexing. It goes from one
+//below the bottom of the world to one above the chunk's height, blocks that aren't in a loaded chunk are air.
+//It doesn't share anything with the neighborhood, so it can be meshed on any thread
+class PaddedChunk {
+public:
+	void Copy(const ChunkNeighborhood& neighborhood);
+
+	//x and z go from -1 to CHUNK_SIZE, y from -1 to Height()
+	static int Index(int x, int y, int z) { return ((y + 1) * PADDED_CHUNK_SIZE + z + 1) * PADDED_CHUNK_SIZE + x + 1; }
+	BlockID At(int x, int y, int z) const { return volume[Index(x, y, z)]; }
+	const BlockID* Data() const { return volume.data(); }
+	//Height of the center chunk
+	int Height() const { return height; }
+	//See ChunkNeighborhood::IsSectionHidden
+	bool IsSectionHidden(int section) const { return hidden[section]; }
+
+private:
+	std::vector<BlockID> volume;
+	std::array<bool, SECTIONS_PER_CHUNK> hidden{};
+	int height = 0;
+};
+
+//Builds the visible faces of the center chunk, the ones that aren't hidden by the block next to them.
+//Greedy meshing merges the faces of the same block facing the same way into the largest rectangles it can,
+//so a flat field of grass is a handful of quads instead of one for every block. Doesn't touch Vulkan, so any thread can mesh
+void BuildChunkMesh(const PaddedChunk& chunk, bool greedy, ChunkGeometry& geometry);
+
+//16 bit indices only reach this many quads, bigger meshes are drawn in parts
+constexpr uint32_t MAX_QUADS_PER_DRAW = 65536 / 4;
+//0, 1, 2, 2, 3, 0 counting up by 4 for MAX_QUADS_PER_DRAW quads, one index buffer of these draws every chunk mesh
+std::vector<uint16_t> QuadIndices();
\ No newline at end of file
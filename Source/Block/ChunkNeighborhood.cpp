@@ -0,0 +1,22 @@
+#include "ChunkNeighborhood.h"
+
+bool ChunkNeighborhood::IsSectionHidden(int section) const {
+	if (!Center() || Center()->IsSectionEmpty(section)) return true;
+
+	//A uniform opaque section boxed in by other uniform opaque sections has no visible faces
+	auto isOpaque = [this](int dx, int dz, int section) {
+		if (section < 0 || section >= SECTIONS_PER_CHUNK) return false;
+		const auto& chunk = Neighbor(dx, dz);
+		if (!chunk || !chunk->IsSectionUniform(section)) return false;
+		BlockID block = chunk->Section(section).UniformBlock();
+		return block > 0 && !(blocks[block - 1].flags & (Block::HOLES | Block::TRANSPARENT));
+	};
+
+	return isOpaque(0, 0, section)
+		&& isOpaque(0, 0, section - 1)
+		&& isOpaque(0, 0, section + 1)
+		&& isOpaque(-1, 0, section)
+		&& isOpaque(1, 0, section)
+		&& isOpaque(0, -1, section)
+		&& isOpaque(0, 1, section);
+}
\ No newline at end of file
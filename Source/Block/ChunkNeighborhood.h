@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Block.h"
+#include "ChunkData.h"
+
+//A chunk and its 8 neighbors as they were when the neighborhood was taken. The chunks are shared,
+//immutable versions: edits made afterwards copy the chunk instead of changing these ones, so once
+//taken (on the main thread) a neighborhood can be read from any thread without locking.
+class ChunkNeighborhood {
+public:
+	ChunkNeighborhood() = default;
+	ChunkNeighborhood(const glm::ivec2& center, const std::array<std::shared_ptr<const Chunk>, 9>& chunks)
+		: center(center), chunks(chunks) {}
+
+	const glm::ivec2& GetCenter() const { return center; }
+	//Null if the chunk wasn't loaded. dx and dz go from -1 to 1
+	const std::shared_ptr<const Chunk>& Neighbor(int dx, int dz) const { return chunks[(dz + 1) * 3 + dx + 1]; }
+	const std::shared_ptr<const Chunk>& Center() const { return chunks[4]; }
+
+	//Block relative to the center chunk, x and z may reach one chunk out on either side.
+	//Air outside of the world or in missing chunks
+	inline BlockID BlockAt(int x, int y, int z) const;
+	BlockID BlockAt(const glm::ivec3& pos) const { return BlockAt(pos.x, pos.y, pos.z); }
+
+	uint32_t NumBlocks() const { return Center() ? Center()->NumBlocks() : 0; }
+	uint32_t MaxHeight() const { return Center() ? Center()->MaxHeight() : 0; }
+	//True if the section of the center chunk can't have any visible faces, so meshing can skip it
+	bool IsSectionHidden(int section) const;
+
+private:
+	glm::ivec2 center{ 0 };
+	std::array<std::shared_ptr<const Chunk>, 9> chunks;
+};
+
+inline BlockID ChunkNeighborhood::BlockAt(int x, int y, int z) const {
+	if (y < 0 || y >= MAX_BLOCK_HEIGHT) return 0;
+
+	int dx = x < 0 ? -1 : (x >= CHUNK_SIZE ? 1 : 0);
+	int dz = z < 0 ? -1 : (z >= CHUNK_SIZE ? 1 : 0);
+	const auto& chunk = Neighbor(dx, dz);
+	if (!chunk) return 0;
+
+	return chunk->Get(x - dx * CHUNK_SIZE, y, z - dz * CHUNK_SIZE);
+}
\ No newline at end of file
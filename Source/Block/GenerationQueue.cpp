@@ -0,0 +1,148 @@
+#include "GenerationQueue.h"
+
+#include <algorithm>
+#include <limits>
+
+GenerationQueue::GenerationQueue(const ChunkGenerator& generator, unsigned threads)
+	: generator(generator), maxDistance(std::numeric_limits<float>::infinity()) {
+	if (threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	for (unsigned i = 0; i < threads; i++) {
+		workers.emplace_back(&GenerationQueue::Work, this);
+	}
+}
+
+GenerationQueue::~GenerationQueue() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void GenerationQueue::RequestTerrain(const std::vector<glm::ivec2>& chunkIDs) {
+	size_t queued = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto& chunkID : chunkIDs) {
+			if (Push(chunkID, GenerationStage::Terrain)) queued++;
+		}
+	}
+
+	if (queued == 1) wake.notify_one();
+	else if (queued > 1) wake.notify_all();
+}
+
+void GenerationQueue::RequestDecoration(const std::vector<std::pair<glm::ivec2, TerrainNeighborhood>>& chunks) {
+	size_t queued = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto& [chunkID, terrain] : chunks) {
+			if (Push(chunkID, GenerationStage::Decoration, terrain)) queued++;
+		}
+	}
+
+	if (queued == 1) wake.notify_one();
+	else if (queued > 1) wake.notify_all();
+}
+
+void GenerationQueue::SetFocus(const glm::vec2& focus, float maxDistance, const glm::vec2& lookAhead) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->focus = focus;
+	this->lookAhead = lookAhead;
+	this->maxDistance = maxDistance;
+
+	//Everything moved relative to the focus, so rebuild the heap with the new distances
+	for (auto iter = jobs.begin(); iter != jobs.end();) {
+		iter->priority = Priority(iter->chunkID);
+		if (iter->priority > maxDistance * maxDistance) {
+			Clear(iter->chunkID, iter->stage);
+			if (&*iter != &jobs.back()) *iter = std::move(jobs.back());
+			jobs.pop_back();
+		}
+		else {
+			++iter;
+		}
+	}
+	std::make_heap(jobs.begin(), jobs.end());
+}
+
+size_t GenerationQueue::Collect(std::vector<GeneratedChunk>& finished) {
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t count = this->finished.size();
+	for (auto& chunk : this->finished) {
+		Clear(chunk.chunkID, chunk.stage);
+		finished.push_back(std::move(chunk));
+	}
+	this->finished.clear();
+	return count;
+}
+
+bool GenerationQueue::IsPending(const glm::ivec2& chunkID, GenerationStage stage) const {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto bits = pending.find(chunkID);
+	return bits != pending.end() && (bits->second & StageBit(stage));
+}
+
+size_t GenerationQueue::Pending() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.size();
+}
+
+void GenerationQueue::Work() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+		if (stopping) return;
+
+		std::pop_heap(jobs.begin(), jobs.end());
+		Job job = std::move(jobs.back());
+		jobs.pop_back();
+
+		lock.unlock();
+		GeneratedChunk chunk;
+		chunk.chunkID = job.chunkID;
+		chunk.stage = job.stage;
+		if (job.stage == GenerationStage::Terrain) {
+			chunk.chunk = generator.GenerateTerrain(job.chunkID);
+		}
+		else {
+			chunk.chunk = generator.Decorate(job.chunkID, job.terrain);
+		}
+		//Let go of the terrain before taking the lock, the last reference may have to free it
+		job.terrain = {};
+		lock.lock();
+
+		//Stays pending until it's collected, so it isn't queued again in the meantime
+		finished.push_back(std::move(chunk));
+	}
+}
+
+bool GenerationQueue::Push(const glm::ivec2& chunkID, GenerationStage stage, const TerrainNeighborhood& terrain) {
+	uint8_t& bits = pending[chunkID];
+	if (bits & StageBit(stage)) return false;
+
+	bits |= StageBit(stage);
+	jobs.push_back({ Priority(chunkID), chunkID, stage, terrain });
+	std::push_heap(jobs.begin(), jobs.end());
+	return true;
+}
+
+void GenerationQueue::Clear(const glm::ivec2& chunkID, GenerationStage stage) {
+	auto bits = pending.find(chunkID);
+	if (bits == pending.end()) return;
+
+	bits->second &= ~StageBit(stage);
+	if (bits->second == 0) pending.erase(bits);
+}
+
+//Squared, only the order matters
+float GenerationQueue::Priority(const glm::ivec2& chunkID) const {
+	return SquaredPathDistance(glm::vec2(chunkID), focus, lookAhead);
+}
\ No newline at end of file
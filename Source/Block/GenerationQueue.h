@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ChunkGenerator.h"
+#include "Util/ChunkMap.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//Squared distance from the point to the stretch from start to start + ahead, the plain squared distance to start without ahead
+inline float SquaredPathDistance(const glm::vec2& point, const glm::vec2& start, const glm::vec2& ahead) {
+	float length = glm::dot(ahead, ahead);
+	float along = length > 0.f ? glm::clamp(glm::dot(point - start, ahead) / length, 0.f, 1.f) : 0.f;
+	glm::vec2 offset = point - (start + ahead * along);
+	return glm::dot(offset, offset);
+}
+
+//Generates chunks on a pool of worker threads, the ones closest to the focus first. Both generation stages share
+//the queue, a decoration job carries the terrain it needs with it so the workers never look at the world.
+//Everything but the workers themselves is called from the main thread, which picks the finished chunks up with Collect
+class GenerationQueue {
+public:
+	//0 threads leaves one core for the main thread and uses the rest
+	GenerationQueue(const ChunkGenerator& generator, unsigned threads = 0);
+	~GenerationQueue();
+
+	GenerationQueue(const GenerationQueue&) = delete;
+	GenerationQueue& operator=(const GenerationQueue&) = delete;
+
+	//Chunks already queued for the same stage, being generated or waiting to be collected are skipped
+	void RequestTerrain(const std::vector<glm::ivec2>& chunkIDs);
+	void RequestDecoration(const std::vector<std::pair<glm::ivec2, TerrainNeighborhood>>& chunks);
+	//Jobs are ordered by their distance (in chunks) to the focus, queued ones further than maxDistance are dropped.
+	//With a look ahead, the distance is to the stretch from the focus to focus + lookAhead, so chunks on the way go first
+	void SetFocus(const glm::vec2& focus, float maxDistance, const glm::vec2& lookAhead = glm::vec2(0.f));
+	//Appends the chunks finished since the last call, returns how many there were
+	size_t Collect(std::vector<GeneratedChunk>& finished);
+
+	bool IsPending(const glm::ivec2& chunkID, GenerationStage stage) const;
+	//Chunks with a stage queued, being generated or waiting to be collected
+	size_t Pending() const;
+	unsigned Threads() const { return unsigned(workers.size()); }
+
+private:
+	struct Job {
+		float priority;
+		glm::ivec2 chunkID;
+		GenerationStage stage;
+		//Only for decoration
+		TerrainNeighborhood terrain;
+		//std::push_heap keeps the largest on top, so the closest job has to compare the largest
+		bool operator<(const Job& other) const { return priority > other.priority; }
+	};
+
+	void Work();
+	//False if the stage was already pending
+	bool Push(const glm::ivec2& chunkID, GenerationStage stage, const TerrainNeighborhood& terrain = {});
+	void Clear(const glm::ivec2& chunkID, GenerationStage stage);
+	float Priority(const glm::ivec2& chunkID) const;
+	static uint8_t StageBit(GenerationStage stage) { return uint8_t(1u << int(stage)); }
+
+	const ChunkGenerator& generator;
+	std::vector<std::thread> workers;
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+	//Heap ordered by priority, kept as a vector so it can be rebuilt when the focus moves
+	std::vector<Job> jobs;
+	//Bit per GenerationStage
+	ChunkMap<uint8_t> pending;
+	std::vector<GeneratedChunk> finished;
+	glm::vec2 focus{ 0.f }, lookAhead{ 0.f };
+	float maxDistance = 0.f;
+	bool stopping = false;
+};
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "RegionFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+RegionFile::RegionFile(const std::filesystem::path& path) : path(path) {
+	if (!std::filesystem::exists(path)) {
+		std::ofstream create(path, std::ios::binary);
+	}
+
+	file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Failed to open region file " + path.string() + "!");
+	}
+
+	file.seekg(0, std::ios::end);
+	fileSize = (uint64_t)file.tellg();
+	file.seekg(0);
+
+	uint32_t header[2] = {};
+	if (fileSize >= HEADER_SIZE) {
+		file.read(reinterpret_cast<char*>(header), sizeof(header));
+		file.read(reinterpret_cast<char*>(entries.data()), sizeof(entries));
+	}
+
+	if (!file || header[0] != MAGIC || header[1] != VERSION) {
+		//New, truncated or outdated file, start it over
+		file.clear();
+		entries = {};
+		header[0] = MAGIC;
+		header[1] = VERSION;
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), sizeof(entries));
+		file.flush();
+		fileSize = HEADER_SIZE;
+	}
+
+	//Drop entries pointing outside of the file, e.g. from a write that got cut off
+	for (auto& entry : entries) {
+		if (entry.offset != 0 && (entry.offset < HEADER_SIZE || entry.offset % sizeof(uint64_t) != 0 || uint64_t(entry.offset) + entry.size > fileSize)) {
+			entry = {};
+		}
+	}
+
+	//Whatever isn't covered by a chunk is free, like the old bytes of chunks that moved in an earlier session
+	std::vector<std::pair<uint64_t, uint64_t>> used;
+	for (const auto& entry : entries) {
+		if (entry.offset != 0) used.emplace_back(entry.offset, Span(entry.size));
+	}
+	std::sort(used.begin(), used.end());
+
+	uint64_t end = HEADER_SIZE;
+	for (const auto& [offset, size] : used) {
+		if (offset > end) Free(end, offset - end);
+		end = std::max(end, offset + size);
+	}
+	Free(end, Span(fileSize) - end);
+}
+
+bool RegionFile::Contains(int x, int z) const {
+	return entries[z * REGION_SIZE + x].offset != 0;
+}
+
+uint32_t RegionFile::Flags(int x, int z) const {
+	return entries[z * REGION_SIZE + x].flags;
+}
+
+bool RegionFile::Read(int x, int z, std::vector<uint8_t>& data) {
+	const Entry& entry = entries[z * REGION_SIZE + x];
+	if (entry.offset == 0) return false;
+
+	data.resize(entry.size);
+	file.seekg(entry.offset);
+	file.read(reinterpret_cast<char*>(data.data()), entry.size);
+	if (!file) {
+		file.clear();
+		return false;
+	}
+
+	return true;
+}
+
+std::shared_ptr<const MappedFile> RegionFile::Map(int x, int z, const uint8_t*& data, size_t& size) {
+	int index = z * REGION_SIZE + x;
+	const Entry& entry = entries[index];
+	if (entry.offset == 0) return nullptr;
+
+	std::shared_ptr<const MappedFile> handle = mapped[index].lock();
+	if (!handle) {
+		if (!mapping || uint64_t(entry.offset) + entry.size > mapping->Size()) {
+			mapping = std::make_shared<MappedFile>(path);
+		}
+
+		//Every chunk gets its own pointer to the mapping, so it's known when nothing reads its bytes anymore
+		handle = std::shared_ptr<const MappedFile>(std::make_shared<std::shared_ptr<const MappedFile>>(mapping), mapping.get());
+		mapped[index] = handle;
+	}
+
+	data = handle->Data() + entry.offset;
+	size = entry.size;
+	return handle;
+}
+
+void RegionFile::Write(int x, int z, const std::vector<uint8_t>& data, uint32_t flags) {
+	int index = z * REGION_SIZE + x;
+	Entry& entry = entries[index];
+	if (data.size() > UINT32_MAX) {
+		throw std::runtime_error("Chunk is too big for region file " + path.string() + "!");
+	}
+
+	//Overwrite in place if the new data fits and nobody can be reading the old data through a mapping, otherwise move it
+	if (entry.offset != 0 && data.size() <= entry.size && mapped[index].expired()) {
+		Free(entry.offset + Span(data.size()), Span(entry.size) - Span(data.size()));
+	}
+	else {
+		//Found before the old bytes are let go of, so the entry still points at them if the file is full
+		uint64_t offset = Allocate(data.size());
+		Release(index);
+		entry.offset = (uint32_t)offset;
+	}
+	entry.size = (uint32_t)data.size();
+	entry.flags = flags;
+
+	file.seekp(entry.offset);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	WriteEntry(index);
+	file.flush();
+
+	if (!file) {
+		throw std::runtime_error("Failed to write to region file!");
+	}
+}
+
+void RegionFile::Erase(int x, int z) {
+	int index = z * REGION_SIZE + x;
+	if (entries[index].offset == 0) return;
+
+	Release(index);
+	entries[index] = {};
+	WriteEntry(index);
+	file.flush();
+
+	if (!file) {
+		throw std::runtime_error("Failed to write to region file!");
+	}
+}
+
+void RegionFile::Release(int index) {
+	const Entry& entry = entries[index];
+	if (entry.offset == 0) return;
+
+	if (mapped[index].expired()) {
+		Free(entry.offset, Span(entry.size));
+	}
+	else {
+		retired.push_back({ entry.offset, Span(entry.size), mapped[index] });
+	}
+	mapped[index].reset();
+}
+
+void RegionFile::Free(uint64_t offset, uint64_t size) {
+	if (size == 0) return;
+
+	auto next = freeSpans.lower_bound(offset);
+	if (next != freeSpans.end() && next->first == offset + size) {
+		size += next->second;
+		next = freeSpans.erase(next);
+	}
+	if (next != freeSpans.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset) {
+			previous->second += size;
+			return;
+		}
+	}
+	freeSpans.emplace(offset, size);
+}
+
+uint64_t RegionFile::Allocate(uint64_t size) {
+	for (auto iter = retired.begin(); iter != retired.end();) {
+		if (iter->mapping.expired()) {
+			Free(iter->offset, iter->size);
+			iter = retired.erase(iter);
+		}
+		else {
+			++iter;
+		}
+	}
+
+	//First fit, chunks are all about the same size so there isn't much to gain from searching further
+	uint64_t span = Span(size);
+	for (auto iter = freeSpans.begin(); iter != freeSpans.end(); ++iter) {
+		if (iter->second < span) continue;
+
+		auto [offset, free] = *iter;
+		freeSpans.erase(iter);
+		Free(offset + span, free - span);
+		fileSize = std::max(fileSize, offset + size);
+		return offset;
+	}
+
+	uint64_t offset = Span(fileSize);
+	if (offset > UINT32_MAX) {
+		throw std::runtime_error("Region file " + path.string() + " is full!");
+	}
+
+	const char zeros[sizeof(uint64_t)] = {};
+	file.seekp(fileSize);
+	file.write(zeros, offset - fileSize);
+	fileSize = offset + size;
+	return offset;
+}
+
+void RegionFile::WriteEntry(int index) {
+	file.seekp(2 * sizeof(uint32_t) + index * sizeof(Entry));
+	file.write(reinterpret_cast<const char*>(&entries[index]), sizeof(Entry));
+}
\ No newline at end of file
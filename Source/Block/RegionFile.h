@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Util/MappedFile.h"
+
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <array>
+#include <memory>
+#include <map>
+#include <cstdint>
+
+constexpr int REGION_SIZE = 32;
+
+//A file holding the saved data of a REGION_SIZE x REGION_SIZE group of chunks.
+//The file starts with an offset table with one entry per chunk, followed by the chunk data.
+//Chunk data is stored as is and starts 8 bytes aligned, so it can be used straight out of a mapping of the file.
+//A chunk that grows, or whose bytes are still being read through Map, is moved when it's written. The space it leaves
+//behind is reused once nothing reads it anymore, and the free space is found again from the offset table when the file is opened.
+class RegionFile {
+public:
+	RegionFile(const std::filesystem::path& path);
+
+	//x and z are the chunk's position inside of the region, from 0 to REGION_SIZE - 1
+	bool Contains(int x, int z) const;
+	//Flags passed to the last Write of the chunk
+	uint32_t Flags(int x, int z) const;
+	//Copies the chunk's data out of the file. Returns false if the chunk isn't in the file
+	bool Read(int x, int z, std::vector<uint8_t>& data);
+	//Points data at the chunk's bytes inside of a read only mapping of the file instead of copying them.
+	//Returns the mapping, which has to be kept alive for as long as data is used, or nullptr if the chunk isn't in the file.
+	//Those bytes aren't overwritten until every copy of the returned pointer is gone, later writes of the chunk go to a new spot
+	std::shared_ptr<const MappedFile> Map(int x, int z, const uint8_t*& data, size_t& size);
+	//Throws if the chunk doesn't fit in the file anymore, offsets are 32 bits
+	void Write(int x, int z, const std::vector<uint8_t>& data, uint32_t flags = 0);
+	//Forgets the chunk, its bytes are reused by later writes
+	void Erase(int x, int z);
+
+private:
+	struct Entry {
+		uint32_t offset; //0 if the chunk isn't stored
+		uint32_t size;
+		uint32_t flags;
+	};
+
+	static constexpr uint32_t MAGIC = 0x47524346; //"FCRG"
+	static constexpr uint32_t VERSION = 2;
+	static constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t) + REGION_SIZE * REGION_SIZE * sizeof(Entry);
+	static_assert(HEADER_SIZE % sizeof(uint64_t) == 0, "Chunk data has to start aligned");
+
+	//Bytes a chunk's data takes up, including the padding up to where the next chunk can start
+	static uint64_t Span(uint64_t size) { return (size + sizeof(uint64_t) - 1) & ~uint64_t(sizeof(uint64_t) - 1); }
+
+	void WriteEntry(int index);
+	//Lets go of the chunk's current bytes, they're free as soon as nothing reads them through Map
+	void Release(int index);
+	void Free(uint64_t offset, uint64_t size);
+	//Aligned spot for size bytes, from the free space if it fits anywhere, otherwise at the end of the file
+	uint64_t Allocate(uint64_t size);
+
+	std::filesystem::path path;
+	std::fstream file;
+	std::array<Entry, REGION_SIZE * REGION_SIZE> entries{};
+	//What Map handed out for each chunk's current bytes. Expired once everyone using them is done
+	std::array<std::weak_ptr<const MappedFile>, REGION_SIZE * REGION_SIZE> mapped;
+	//Bytes of old chunk data that were still mapped when they were replaced, free once their mapping expires
+	struct Retired {
+		uint64_t offset, size;
+		std::weak_ptr<const MappedFile> mapping;
+	};
+	std::vector<Retired> retired;
+	//Offset to size of the unused spans between chunks, adjacent ones are merged
+	std::map<uint64_t, uint64_t> freeSpans;
+	uint64_t fileSize;
+	//Replaced with a bigger one when a chunk past its end is mapped, older ones live on through the chunks using them
+	std::shared_ptr<const MappedFile> mapping;
+};
\ No newline at end of file
@@ -3,7 +3,8 @@
 #include "Systems\ChunkRenderer.h"
 #include "Systems\UIRenderer.h"
 
-constexpr int TPS = 100;
+//Where F9 dumps the memory usage of every subsystem
+constexpr const char* MEMORY_REPORT_PATH = "memory.json";
 
 App::App() {
 	pool = DescriptorPool::Builder(device)
@@ -101,6 +102,15 @@ void App::ReDraw() {
 
 		chunkManager.Update(updateEvent);
 
+		if (updateEvent.input.GetKeyState(GLFW_KEY_F9) == InputSystem::Pressed) {
+			if (MemoryTracker::WriteJson(MEMORY_REPORT_PATH)) {
+				std::cout << "Memory report written to " << MEMORY_REPORT_PATH << std::endl;
+			}
+			else {
+				std::cerr << "Failed to write memory report to " << MEMORY_REPORT_PATH << std::endl;
+			}
+		}
+
 		std::sort(systems.begin(), systems.end(), [](const std::unique_ptr<RenderSystemBase>& a, const std::unique_ptr<RenderSystemBase>& b) {
 			return a->UpdateWeight() < b->UpdateWeight();
 			});
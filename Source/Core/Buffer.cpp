@@ -9,6 +9,11 @@ VkDeviceSize Buffer::GetAlignment(VkDeviceSize instanceSize, VkDeviceSize minOff
 	}
 }
 
+//Chunk meshes count themselves instead of their buffers, so the objects of that category are meshes
+static int64_t TrackedObjects(MemoryCategory category) {
+	return category == MemoryCategory::ChunkMeshes ? 0 : 1;
+}
+
 Buffer::Buffer(
 	Device& device,
 	VkDeviceSize instanceSize,
@@ -16,8 +21,9 @@ Buffer::Buffer(
 	VkBufferUsageFlags usage,
 	VkMemoryPropertyFlags memProps,
 	Device::QueueFamilyIndices::Family families,
-	VkDeviceSize minOffsetAlignment
-) : device(device) {
+	VkDeviceSize minOffsetAlignment,
+	MemoryCategory category
+) : device(device), category(category) {
 	this->instanceSize = GetAlignment(instanceSize, minOffsetAlignment);
 	bufferSize = instanceCount * this->instanceSize;
 	if (device.CreateBuffer(
@@ -30,9 +36,18 @@ Buffer::Buffer(
 	) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create buffer!");
 	}
+
+	VkMemoryRequirements memRequirements;
+	vkGetBufferMemoryRequirements(device.GetDevice(), buffer, &memRequirements);
+	allocationSize = memRequirements.size;
+	if (category == MemoryCategory::Buffers && usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT) {
+		this->category = MemoryCategory::StagingBuffers;
+	}
+	MemoryTracker::Add(this->category, allocationSize, TrackedObjects(this->category));
 }
 
 Buffer::~Buffer() {
+	MemoryTracker::Remove(category, allocationSize, TrackedObjects(category));
 	UnMap();
 	vkFreeMemory(device.GetDevice(), memory, nullptr);
 	vkDestroyBuffer(device.GetDevice(), buffer, nullptr);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Device.h"
+#include "Util\MemoryTracker.h"
 
 class Buffer {
 public:
@@ -11,7 +12,9 @@ public:
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags memProps,
 		Device::QueueFamilyIndices::Family families,
-		VkDeviceSize minOffsetAlignment = 0u
+		VkDeviceSize minOffsetAlignment = 0u,
+		//Buffers only used as copy sources are counted as staging buffers
+		MemoryCategory category = MemoryCategory::Buffers
 	);
 
 	~Buffer();
@@ -49,6 +52,8 @@ private:
 	bool isMapped = false;
 	VkDeviceSize bufferSize;
 	VkDeviceSize instanceSize;
+	VkDeviceSize allocationSize;
+	MemoryCategory category;
 
 	Device& device;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Descriptors.h"
+#include "Util\MemoryTracker.h"
 
 DescriptorPool::DescriptorPool(Device& device, const std::vector<VkDescriptorPoolSize> poolSizes, uint32_t maxSets) : device(device) {
 	VkDescriptorPoolCreateInfo createInfo{};
@@ -10,9 +11,11 @@ DescriptorPool::DescriptorPool(Device& device, const std::vector<VkDescriptorPoo
 	if (vkCreateDescriptorPool(device.GetDevice(), &createInfo, nullptr, &pool) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create descriptor pool!");
 	}
+	MemoryTracker::Add(MemoryCategory::DescriptorPools, 0);
 }
 
 DescriptorPool::~DescriptorPool() {
+	MemoryTracker::Remove(MemoryCategory::DescriptorPools, 0);
 	vkDestroyDescriptorPool(device.GetDevice(), pool, nullptr);
 }
 
@@ -21,6 +21,9 @@ struct UpdateEvent {
 	const Camera& mainCamera;
 };
 
+//Ticks per second
+constexpr int TPS = 100;
+
 struct TickEvent {
 	const float elapsedTime;
 	const class InputSystem& input;
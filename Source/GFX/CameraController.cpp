@@ -86,6 +86,9 @@ void CameraController::Update(const UpdateEvent& event) {
 		breakCooldown += event.deltaTime;
 	}
 
+	//So the chunk manager can get the chunks we're heading for ready before we're there
+	manager.SetPlayerVelocity(Velocity());
+
 	selectedBlock += int(event.input.GetScrollDelta().y);
 	selectedBlock %= blocks.size();
 
@@ -107,6 +110,10 @@ void CameraController::Tick(const TickEvent& event) {
 	camera.SetPos(camera.GetPos() + vel * MOVE_SPEED);
 }
 
+glm::vec3 CameraController::Velocity() const {
+	return vel * MOVE_SPEED * float(TPS);
+}
+
 bool CameraController::GetSelectedBlockPos(glm::ivec3& blockPos) const {
 	glm::vec3 pos = camera.GetPos();
 	glm::vec3 dir = camera.Forward();
@@ -13,6 +13,8 @@ public:
 
 	BlockID SelectedBlock() const { return selectedBlock; }
 	bool GetSelectedBlockPos(glm::ivec3& blockPos) const;
+	//In blocks per second
+	glm::vec3 Velocity() const;
 
 private:
 	Camera& camera;
@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "Core\Buffer.h"
+#include "Util\MemoryTracker.h"
 
 #ifdef _MSC_VER
 #pragma warning (push, 0)
@@ -69,6 +70,11 @@ Texture::Texture(
 		throw std::runtime_error(ss.str());
 	}
 
+	VkMemoryRequirements memRequirements;
+	vkGetImageMemoryRequirements(device.GetDevice(), image, &memRequirements);
+	allocationSize = memRequirements.size;
+	MemoryTracker::Add(MemoryCategory::Textures, allocationSize);
+
 	if (device.CreateImageView(
 		image,
 		format,
@@ -143,6 +149,7 @@ Texture::Texture(
 
 Texture::~Texture() {
 	if (memory != VK_NULL_HANDLE) {
+		MemoryTracker::Remove(MemoryCategory::Textures, allocationSize);
 		vkDestroySampler(device.GetDevice(), sampler, nullptr);
 		vkDestroyImageView(device.GetDevice(), imageView, nullptr);
 		vkFreeMemory(device.GetDevice(), memory, nullptr);
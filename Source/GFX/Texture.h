@@ -77,6 +77,7 @@ private:
 	VkImageView imageView;
 	VkDeviceMemory memory = VK_NULL_HANDLE;
 	VkSampler sampler = VK_NULL_HANDLE;
+	VkDeviceSize allocationSize = 0;
 
 	uint32_t width, height, depth, mipLevels;
 	VkImageAspectFlags aspect;
@@ -27,6 +27,26 @@
 #include "Noise.h"
 
 #include <cstdint>  // int32_t/uint8_t
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Util/Random.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMPLEX_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC lets any intrinsic be used no matter what /arch is set to
+#define SIMPLEX_TARGET(isa)
+#else
+#include <cpuid.h>
+// GCC and Clang need the instruction set enabled on each function that uses it, so the rest of the
+// file still runs on CPUs without it
+#define SIMPLEX_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
 
  /**
   * Computes the largest integer value not greater than the float one
@@ -54,9 +74,8 @@ static inline int32_t fastfloor(float fp) {
  * that it is not a problem for graphic texture as the noise features disappear
  * at a distance far enough to be able to see a repeatable pattern of 256.
  *
- * This needs to be exactly the same for all instances on all platforms,
- * so it's easiest to just keep it as static explicit data.
- * This also removes the need for any initialisation of this class.
+ * This is the table of seed 0, kept so worlds made before noise was seedable come out the same.
+ * Every other seed shuffles it into a table of its own, see reseed().
  *
  * Note that making this an uint32_t[] instead of a uint8_t[] might make the
  * code run faster on platforms with a high penalty for unaligned single
@@ -68,7 +87,7 @@ static inline int32_t fastfloor(float fp) {
  * A vector-valued noise over 3D accesses it 96 times, and a
  * float-valued 4D noise 64 times. We want this to fit in the cache!
  */
-static const uint8_t perm[256] = {
+static constexpr uint8_t perm[256] = {
     151, 160, 137, 91, 90, 15,
     131, 13, 201, 95, 96, 53, 194, 233, 7, 225, 140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23,
     190, 6, 148, 247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32, 57, 177, 33,
@@ -85,7 +104,7 @@ static const uint8_t perm[256] = {
 };
 
 /**
- * Helper function to hash an integer using the above permutation table
+ * Helper function to hash an integer using the permutation table of this instance
  *
  *  This inline function costs around 1ns, and is called N+1 times for a noise of N dimension.
  *
@@ -96,8 +115,27 @@ static const uint8_t perm[256] = {
  *
  * @return 8-bits hashed value
  */
-static inline uint8_t hash(int32_t i) {
-    return perm[static_cast<uint8_t>(i)];
+inline int32_t SimplexNoise::hash(int32_t i) const {
+    return mPerm[static_cast<uint8_t>(i)];
+}
+
+/**
+ * Fill the permutation table for a seed
+ *
+ * Seed 0 is the classic table above, any other seed is a Fisher-Yates shuffle of it driven by the seed,
+ * so the same seed always gives the same table on every platform.
+ *
+ * @param[in] seed  seed of the table
+ */
+void SimplexNoise::reseed(uint64_t seed) {
+    mSeed = seed;
+    for (int i = 0; i < 256; i++) mPerm[i] = perm[i];
+    if (seed == 0) return;
+
+    Random random(seed, 0, 0);
+    for (uint32_t i = 255; i > 0; i--) {
+        std::swap(mPerm[i], mPerm[random.NextInt(i + 1)]);
+    }
 }
 
 /* NOTE Gradient table to test if lookup-table are more efficient than calculs
@@ -172,7 +210,7 @@ static float grad(int32_t hash, float x, float y, float z) {
  *
  * @return Noise value in the range[-1; 1], value of 0 on all integer coordinates.
  */
-float SimplexNoise::noise(float x) {
+float SimplexNoise::noise(float x) const {
     float n0, n1;   // Noise contributions from the two "corners"
 
     // No need to skew the input space in 1D
@@ -211,7 +249,7 @@ float SimplexNoise::noise(float x) {
  *
  * @return Noise value in the range[-1; 1], value of 0 on all integer coordinates.
  */
-float SimplexNoise::noise(float x, float y) {
+float SimplexNoise::noise(float x, float y) const {
     float n0, n1, n2;   // Noise contributions from the three corners
 
     // Skewing/Unskewing factors for 2D
@@ -303,7 +341,7 @@ float SimplexNoise::noise(float x, float y) {
  *
  * @return Noise value in the range[-1; 1], value of 0 on all integer coordinates.
  */
-float SimplexNoise::noise(float x, float y, float z) {
+float SimplexNoise::noise(float x, float y, float z) const {
     float n0, n1, n2, n3; // Noise contributions from the four corners
 
     // Skewing/Unskewing factors for 3D
@@ -485,4 +523,270 @@ float SimplexNoise::fractal(size_t octaves, float x, float y, float z) const {
     }
 
     return (output / denom);
-}
\ No newline at end of file
+}
+
+/**
+ * Batch versions of the 2D noise, one point per SIMD lane.
+ *
+ * Every lane goes through exactly the same float operations in the same order as noise(x, y), just with the
+ * branches turned into masks, so the results match it bit for bit. The permutation table is kept as
+ * int32 so AVX2 can gather from it.
+ */
+#ifdef SIMPLEX_X86
+enum class SimdLevel {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+static SimdLevel detectSimdLevel() {
+    int info[4] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+#else
+    unsigned int maxLeaf = __get_cpuid_max(0, nullptr);
+    __cpuid(1, info[0], info[1], info[2], info[3]);
+#endif
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        __cpuidex(info, 7, 0);
+        const bool ymmEnabled = (_xgetbv(0) & 6) == 6;
+#else
+        __cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+        unsigned int xcr0Low, xcr0High;
+        __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        const bool ymmEnabled = (xcr0Low & 6) == 6;
+#endif
+        // The OS has to save the upper halves of the ymm registers too
+        avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel cpuSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SIMPLEX_TARGET("sse4.1") static inline __m128 gradSse41(__m128i hash, __m128 x, __m128 y) {
+    const __m128i h = _mm_and_si128(hash, _mm_set1_epi32(0x3F));
+    const __m128 low = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    const __m128 u = _mm_blendv_ps(y, x, low);
+    const __m128 v = _mm_blendv_ps(x, y, low);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 negU = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    const __m128 negV = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    const __m128 twoV = _mm_mul_ps(_mm_set1_ps(2.0f), v);
+    return _mm_add_ps(_mm_xor_ps(u, _mm_and_ps(negU, sign)), _mm_xor_ps(twoV, _mm_and_ps(negV, sign)));
+}
+
+SIMPLEX_TARGET("sse4.1") static inline __m128 cornerSse41(__m128i hash, __m128 x, __m128 y) {
+    __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y));
+    const __m128 outside = _mm_cmplt_ps(t, _mm_setzero_ps());
+    t = _mm_mul_ps(t, t);
+    return _mm_andnot_ps(outside, _mm_mul_ps(_mm_mul_ps(t, t), gradSse41(hash, x, y)));
+}
+
+SIMPLEX_TARGET("sse4.1") static inline __m128i hashSse41(const int32_t* perm, __m128i i) {
+    alignas(16) int32_t values[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(values), i);
+    for (int lane = 0; lane < 4; lane++) values[lane] = perm[static_cast<uint8_t>(values[lane])];
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+SIMPLEX_TARGET("sse4.1") static void noiseSse41(const int32_t* perm, const float* px, const float* py, float* out) {
+    const __m128 F2 = _mm_set1_ps(0.366025403f);
+    const __m128 G2 = _mm_set1_ps(0.211324865f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i oneInt = _mm_set1_epi32(1);
+
+    const __m128 x = _mm_loadu_ps(px);
+    const __m128 y = _mm_loadu_ps(py);
+    const __m128 s = _mm_mul_ps(_mm_add_ps(x, y), F2);
+    const __m128i i = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(x, s)));
+    const __m128i j = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(y, s)));
+
+    const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), G2);
+    const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+    const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+    const __m128 lower = _mm_cmpgt_ps(x0, y0);
+    const __m128i i1 = _mm_and_si128(_mm_castps_si128(lower), oneInt);
+    const __m128i j1 = _mm_andnot_si128(_mm_castps_si128(lower), oneInt);
+    const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_cvtepi32_ps(i1)), G2);
+    const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_cvtepi32_ps(j1)), G2);
+    const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, one), _mm_set1_ps(2.0f * 0.211324865f));
+    const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, one), _mm_set1_ps(2.0f * 0.211324865f));
+
+    const __m128i gi0 = hashSse41(perm, _mm_add_epi32(i, hashSse41(perm, j)));
+    const __m128i gi1 = hashSse41(perm, _mm_add_epi32(_mm_add_epi32(i, i1), hashSse41(perm, _mm_add_epi32(j, j1))));
+    const __m128i gi2 = hashSse41(perm, _mm_add_epi32(_mm_add_epi32(i, oneInt), hashSse41(perm, _mm_add_epi32(j, oneInt))));
+
+    const __m128 n = _mm_add_ps(_mm_add_ps(cornerSse41(gi0, x0, y0), cornerSse41(gi1, x1, y1)), cornerSse41(gi2, x2, y2));
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_set1_ps(45.23065f), n));
+}
+
+SIMPLEX_TARGET("avx2") static inline __m256 gradAvx2(__m256i hash, __m256 x, __m256 y) {
+    const __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(0x3F));
+    const __m256 low = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    const __m256 u = _mm256_blendv_ps(y, x, low);
+    const __m256 v = _mm256_blendv_ps(x, y, low);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 negU = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    const __m256 negV = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+    const __m256 twoV = _mm256_mul_ps(_mm256_set1_ps(2.0f), v);
+    return _mm256_add_ps(_mm256_xor_ps(u, _mm256_and_ps(negU, sign)), _mm256_xor_ps(twoV, _mm256_and_ps(negV, sign)));
+}
+
+SIMPLEX_TARGET("avx2") static inline __m256 cornerAvx2(__m256i hash, __m256 x, __m256 y) {
+    __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+    const __m256 outside = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ);
+    t = _mm256_mul_ps(t, t);
+    return _mm256_andnot_ps(outside, _mm256_mul_ps(_mm256_mul_ps(t, t), gradAvx2(hash, x, y)));
+}
+
+SIMPLEX_TARGET("avx2") static inline __m256i hashAvx2(const int32_t* perm, __m256i i) {
+    return _mm256_i32gather_epi32(perm, _mm256_and_si256(i, _mm256_set1_epi32(255)), 4);
+}
+
+SIMPLEX_TARGET("avx2") static void noiseAvx2(const int32_t* perm, const float* px, const float* py, float* out) {
+    const __m256 F2 = _mm256_set1_ps(0.366025403f);
+    const __m256 G2 = _mm256_set1_ps(0.211324865f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i oneInt = _mm256_set1_epi32(1);
+
+    const __m256 x = _mm256_loadu_ps(px);
+    const __m256 y = _mm256_loadu_ps(py);
+    const __m256 s = _mm256_mul_ps(_mm256_add_ps(x, y), F2);
+    const __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(x, s)));
+    const __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(y, s)));
+
+    const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(i, j)), G2);
+    const __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+    const __m256 y0 = _mm256_sub_ps(y, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+
+    const __m256 lower = _mm256_cmp_ps(x0, y0, _CMP_GT_OQ);
+    const __m256i i1 = _mm256_and_si256(_mm256_castps_si256(lower), oneInt);
+    const __m256i j1 = _mm256_andnot_si256(_mm256_castps_si256(lower), oneInt);
+    const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2);
+    const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2);
+    const __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, one), _mm256_set1_ps(2.0f * 0.211324865f));
+    const __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, one), _mm256_set1_ps(2.0f * 0.211324865f));
+
+    const __m256i gi0 = hashAvx2(perm, _mm256_add_epi32(i, hashAvx2(perm, j)));
+    const __m256i gi1 = hashAvx2(perm, _mm256_add_epi32(_mm256_add_epi32(i, i1), hashAvx2(perm, _mm256_add_epi32(j, j1))));
+    const __m256i gi2 = hashAvx2(perm, _mm256_add_epi32(_mm256_add_epi32(i, oneInt), hashAvx2(perm, _mm256_add_epi32(j, oneInt))));
+
+    const __m256 n = _mm256_add_ps(_mm256_add_ps(cornerAvx2(gi0, x0, y0), cornerAvx2(gi1, x1, y1)), cornerAvx2(gi2, x2, y2));
+    _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_set1_ps(45.23065f), n));
+    // Going back to SSE code with dirty upper halves is slow
+    _mm256_zeroupper();
+}
+#endif
+
+/**
+ * 2D Perlin simplex noise of count points
+ *
+ * @param[in] x     x float coordinates
+ * @param[in] y     y float coordinates
+ * @param[out] out  noise values, the same as noise(x[i], y[i])
+ * @param[in] count number of points
+ */
+void SimplexNoise::noise(const float* x, const float* y, float* out, size_t count) const {
+    size_t i = 0;
+#ifdef SIMPLEX_X86
+    const SimdLevel simd = cpuSimdLevel();
+    if (simd == SimdLevel::AVX2) {
+        for (; i + 8 <= count; i += 8) noiseAvx2(mPerm, x + i, y + i, out + i);
+    }
+    else if (simd == SimdLevel::SSE41) {
+        for (; i + 4 <= count; i += 4) noiseSse41(mPerm, x + i, y + i, out + i);
+    }
+#endif
+    for (; i < count; i++) out[i] = noise(x[i], y[i]);
+}
+
+/**
+ * Fractal/Fractional Brownian Motion (fBm) summation of 2D Perlin Simplex noise over count points
+ *
+ * @param[in] octaves   number of fraction of noise to sum
+ * @param[in] x         x float coordinates
+ * @param[in] y         y float coordinates
+ * @param[out] out      noise values, the same as fractal(octaves, x[i], y[i])
+ * @param[in] count     number of points
+ */
+void SimplexNoise::fractal(size_t octaves, const float* x, const float* y, float* out, size_t count) const {
+    // A block of points at a time, so the scaled coordinates stay in the L1 cache
+    constexpr size_t BLOCK = 256;
+    float xs[BLOCK], ys[BLOCK], values[BLOCK];
+
+    for (size_t start = 0; start < count; start += BLOCK) {
+        const size_t size = std::min(BLOCK, count - start);
+        float* output = out + start;
+        std::fill(output, output + size, 0.f);
+
+        float denom = 0.f;
+        float frequency = mFrequency;
+        float amplitude = mAmplitude;
+        for (size_t octave = 0; octave < octaves; octave++) {
+            for (size_t i = 0; i < size; i++) {
+                xs[i] = x[start + i] * frequency;
+                ys[i] = y[start + i] * frequency;
+            }
+            noise(xs, ys, values, size);
+            for (size_t i = 0; i < size; i++) {
+                output[i] += (amplitude * values[i]);
+            }
+            denom += amplitude;
+
+            frequency *= mLacunarity;
+            amplitude *= mPersistence;
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            output[i] = (output[i] / denom);
+        }
+    }
+}
+
+/**
+ * Fractal/Fractional Brownian Motion (fBm) summation of 2D Perlin Simplex noise over a grid
+ *
+ * @param[in] octaves   number of fraction of noise to sum
+ * @param[in] x         x float coordinate of the first point
+ * @param[in] y         y float coordinate of the first point
+ * @param[in] width     number of points along x
+ * @param[in] height    number of points along y
+ * @param[out] out      width * height noise values, row by row
+ * @param[in] spacing   distance between neighboring points
+ */
+void SimplexNoise::fractalGrid(size_t octaves, float x, float y, size_t width, size_t height, float* out, float spacing) const {
+    std::vector<float> xs(width * height), ys(width * height);
+    for (size_t row = 0; row < height; row++) {
+        for (size_t column = 0; column < width; column++) {
+            xs[row * width + column] = x + column * spacing;
+            ys[row * width + column] = y + row * spacing;
+        }
+    }
+
+    fractal(octaves, xs.data(), ys.data(), out, width * height);
+}
+
+const char* SimplexNoise::simdLevel() {
+#ifdef SIMPLEX_X86
+    const SimdLevel simd = cpuSimdLevel();
+    if (simd == SimdLevel::AVX2) return "AVX2";
+    if (simd == SimdLevel::SSE41) return "SSE4.1";
+#endif
+    return "scalar";
+}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <cstddef>  // size_t
+#include <cstdint>  // int32_t/uint64_t
 
  /**
   * @brief A Perlin Simplex Noise C++ Implementation (1D, 2D, 3D, 4D).
@@ -17,17 +18,27 @@
 class SimplexNoise {
 public:
     // 1D Perlin simplex noise
-    static float noise(float x);
+    float noise(float x) const;
     // 2D Perlin simplex noise
-    static float noise(float x, float y);
+    float noise(float x, float y) const;
     // 3D Perlin simplex noise
-    static float noise(float x, float y, float z);
+    float noise(float x, float y, float z) const;
 
     // Fractal/Fractional Brownian Motion (fBm) noise summation
     float fractal(size_t octaves, float x) const;
     float fractal(size_t octaves, float x, float y) const;
     float fractal(size_t octaves, float x, float y, float z) const;
 
+    // Batches of 2D noise, count points at a time, using AVX2 or SSE4.1 lanes when the CPU has them.
+    // The results are bit-identical to calling the single point versions in a loop, as long as the
+    // compiler isn't allowed to fuse multiply-adds (the default for MSVC, and for GCC/Clang unless FMA is enabled).
+    void noise(const float* x, const float* y, float* out, size_t count) const;
+    void fractal(size_t octaves, const float* x, const float* y, float* out, size_t count) const;
+    // width x height grid of fBm values starting at (x, y), spacing apart, out[row * width + column]
+    void fractalGrid(size_t octaves, float x, float y, size_t width, size_t height, float* out, float spacing = 1.0f) const;
+    // "AVX2", "SSE4.1" or "scalar", whichever the batch functions use on this CPU
+    static const char* simdLevel();
+
     /**
      * Constructor of to initialize a fractal noise summation
      *
@@ -35,21 +46,33 @@ public:
      * @param[in] amplitude    Amplitude ("height") of the first octave of noise (default to 1.0)
      * @param[in] lacunarity   Lacunarity specifies the frequency multiplier between successive octaves (default to 2.0).
      * @param[in] persistence  Persistence is the loss of amplitude between successive octaves (usually 1/lacunarity)
+     * @param[in] seed         Seed of the permutation table, noise with different seeds is uncorrelated (default to 0, the classic table)
      */
     explicit SimplexNoise(float frequency = 1.0f,
         float amplitude = 1.0f,
         float lacunarity = 2.0f,
-        float persistence = 0.5f) :
+        float persistence = 0.5f,
+        uint64_t seed = 0) :
         mFrequency(frequency),
         mAmplitude(amplitude),
         mLacunarity(lacunarity),
         mPersistence(persistence) {
+        reseed(seed);
     }
 
+    // Same seed, same noise, on every platform
+    void reseed(uint64_t seed);
+    uint64_t seed() const { return mSeed; }
+
 private:
+    int32_t hash(int32_t i) const;
+
     // Parameters of Fractional Brownian Motion (fBm) : sum of N "octaves" of noise
     float mFrequency;   ///< Frequency ("width") of the first octave of noise (default to 1.0)
     float mAmplitude;   ///< Amplitude ("height") of the first octave of noise (default to 1.0)
     float mLacunarity;  ///< Lacunarity specifies the frequency multiplier between successive octaves (default to 2.0).
     float mPersistence; ///< Persistence is the loss of amplitude between successive octaves (usually 1/lacunarity)
+
+    uint64_t mSeed;
+    int32_t mPerm[256]; ///< Permutation table, 32 bits per entry so the SIMD path can gather straight from it
 };
\ No newline at end of file
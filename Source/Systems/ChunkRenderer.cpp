@@ -1,5 +1,6 @@
 #include "ChunkRenderer.h"
 #include "GFX/CameraController.h"
+#include "Block\ChunkMesher.h"
 
 struct ChunkPushConstants {
 	glm::ivec2 pos;
@@ -9,6 +10,12 @@ struct ShadowUBO {
 	glm::mat4 lightTransform;
 };
 
+//Chunk meshes are made of ChunkVertex, not Vertex. The vertex shaders unpack it
+static void SetChunkVertexInput(GraphicsPipeline::Settings& settings) {
+	settings.vertexInput.bindingDescriptions = { VkVertexInputBindingDescription{ 0, sizeof(ChunkVertex), VK_VERTEX_INPUT_RATE_VERTEX } };
+	settings.vertexInput.attributeDescriptions = { VkVertexInputAttributeDescription{ 0, 0, VK_FORMAT_R32_UINT, offsetof(ChunkVertex, data) } };
+}
+
 ChunkRenderer::ChunkRenderer(Device& device, Renderer& renderer, PipelineCache& cache, VkDescriptorSetLayout globalSetLayout, CameraController& camera, ChunkManager& chunks)
 	: RenderSystem(renderer), manager(chunks), camera(camera) {
 	RegisterRenderHandler("Global", 0, 10.f, &ChunkRenderer::GlobalRender);
@@ -45,6 +52,7 @@ ChunkRenderer::ChunkRenderer(Device& device, Renderer& renderer, PipelineCache&
 
 	GraphicsPipeline::Settings pipelineSettings{};
 	GraphicsPipeline::DefaultSettings(pipelineSettings);
+	SetChunkVertexInput(pipelineSettings);
 	pipelineSettings.renderPass = renderer["Global"].GetRenderPass();
 	pipelineSettings.subpass = 0;
 	pipelineSettings.shaders.push_back(Pipeline::Shader{ device, "Shaders\\chunk.vert.spv", VK_SHADER_STAGE_VERTEX_BIT });
@@ -103,6 +111,7 @@ ChunkRenderer::ChunkRenderer(Device& device, Renderer& renderer, PipelineCache&
 	layoutSettings.layouts.push_back(shadowLayout->GetLayout());
 
 	GraphicsPipeline::DefaultSettings(pipelineSettings);
+	SetChunkVertexInput(pipelineSettings);
 	pipelineSettings.shaders.push_back(Pipeline::Shader{ device, "Shaders\\shadow.vert.spv", VK_SHADER_STAGE_VERTEX_BIT });
 	pipelineSettings.renderPass = renderer["Shadow"].GetRenderPass();
 	pipelineSettings.subpass = 0;
@@ -240,6 +249,7 @@ void ChunkRenderer::GlobalRender(RenderEvent& event) {
 		}
 
 		const glm::vec2 camForward = glm::vec2{ event.mainCamera.Forward().x, event.mainCamera.Forward().z };
+		manager.CountMissingMeshes(event.mainCamera.GetPos(), event.mainCamera.Forward());
 
 		for (auto iter = manager.sortedChunks.rbegin(); iter != manager.sortedChunks.rend(); ++iter) {
 			if (manager.chunks[*iter]->Loaded()) {
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+//Hash map keyed by chunk coordinates, in place of std::unordered_map<glm::ivec2, T>.
+//Lookups probe a flat table of (key, index) slots with linear probing, and the entries themselves are
+//kept packed in a vector, so iterating is as fast as iterating a vector. The last key found is cached,
+//which makes repeated lookups of the same chunk (like BlockAt and raycasts do) skip the probe entirely.
+//Like std::vector, inserting or erasing invalidates references and iterators to the entries,
+//erase(iterator) returns the iterator to continue from. Not thread safe, even for lookups.
+template<typename T>
+class ChunkMap {
+public:
+	using value_type = std::pair<glm::ivec2, T>;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	ChunkMap() { Rehash(MIN_CAPACITY); }
+
+	size_t size() const { return values.size(); }
+	bool empty() const { return values.empty(); }
+
+	iterator begin() { return values.begin(); }
+	iterator end() { return values.end(); }
+	const_iterator begin() const { return values.begin(); }
+	const_iterator end() const { return values.end(); }
+
+	iterator find(const glm::ivec2& key) {
+		uint32_t index = Lookup(key);
+		return index == EMPTY ? values.end() : values.begin() + index;
+	}
+
+	const_iterator find(const glm::ivec2& key) const {
+		uint32_t index = Lookup(key);
+		return index == EMPTY ? values.end() : values.begin() + index;
+	}
+
+	bool contains(const glm::ivec2& key) const { return Lookup(key) != EMPTY; }
+
+	T& operator[](const glm::ivec2& key) {
+		uint32_t index = Lookup(key);
+		if (index != EMPTY) return values[index].second;
+
+		//Kept at most half full, past that probe lengths get long enough for the branch mispredicts to show
+		if ((values.size() + 1) * 2 > slots.size()) {
+			Rehash(slots.size() * 2);
+		}
+
+		index = uint32_t(values.size());
+		values.emplace_back(key, T{});
+		slots[FindSlot(key)] = { key, index };
+
+		cachedKey = key;
+		cachedIndex = index;
+		return values[index].second;
+	}
+
+	iterator erase(iterator iter) {
+		uint32_t index = uint32_t(iter - values.begin());
+		RemoveSlot(FindSlot(iter->first));
+
+		//Fill the gap with the last entry so the entries stay packed
+		if (index != values.size() - 1) {
+			values[index] = std::move(values.back());
+			slots[FindSlot(values[index].first)].index = index;
+		}
+		values.pop_back();
+
+		cachedIndex = EMPTY;
+		return values.begin() + index;
+	}
+
+	size_t erase(const glm::ivec2& key) {
+		auto iter = find(key);
+		if (iter == values.end()) return 0;
+		erase(iter);
+		return 1;
+	}
+
+	void clear() {
+		values.clear();
+		Rehash(MIN_CAPACITY);
+	}
+
+private:
+	struct Slot {
+		glm::ivec2 key;
+		uint32_t index; //Into values, EMPTY if the slot is free
+	};
+
+	static constexpr uint32_t EMPTY = ~0u;
+	static constexpr size_t MIN_CAPACITY = 64;
+
+	//Chunk coordinates are small and clustered, so they need a proper mix before masking
+	//off the low bits, glm's hash combine leaves neighboring chunks in neighboring buckets
+	static size_t Hash(const glm::ivec2& key) {
+		uint64_t h = (uint64_t(uint32_t(key.x)) << 32) | uint32_t(key.y);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return size_t(h);
+	}
+
+	uint32_t Lookup(const glm::ivec2& key) const {
+		if (cachedIndex != EMPTY && cachedKey == key) return cachedIndex;
+
+		for (size_t slot = Hash(key) & mask;; slot = (slot + 1) & mask) {
+			if (slots[slot].index == EMPTY) return EMPTY;
+			if (slots[slot].key == key) {
+				cachedKey = key;
+				cachedIndex = slots[slot].index;
+				return cachedIndex;
+			}
+		}
+	}
+
+	//The slot holding the key, or the free slot it would go in
+	size_t FindSlot(const glm::ivec2& key) const {
+		size_t slot = Hash(key) & mask;
+		while (slots[slot].index != EMPTY && slots[slot].key != key) {
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	//Backward shift deletion, so there are no tombstones to slow down later probes
+	void RemoveSlot(size_t hole) {
+		for (size_t slot = (hole + 1) & mask; slots[slot].index != EMPTY; slot = (slot + 1) & mask) {
+			size_t home = Hash(slots[slot].key) & mask;
+			//Move the entry back if the hole is between its home slot and where it is now
+			if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+				slots[hole] = slots[slot];
+				hole = slot;
+			}
+		}
+		slots[hole].index = EMPTY;
+	}
+
+	void Rehash(size_t capacity) {
+		slots.assign(capacity, Slot{ glm::ivec2{ 0 }, EMPTY });
+		mask = capacity - 1;
+		for (uint32_t i = 0; i < values.size(); i++) {
+			slots[FindSlot(values[i].first)] = { values[i].first, i };
+		}
+	}
+
+	std::vector<Slot> slots;
+	std::vector<value_type> values;
+	size_t mask = 0;
+	mutable glm::ivec2 cachedKey{ 0 };
+	mutable uint32_t cachedIndex = EMPTY;
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+	//Share writes, the file is usually still open for writing elsewhere
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Failed to open " + path.string() + " for mapping!");
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		throw std::runtime_error("Failed to map " + path.string() + "!");
+	}
+
+	//The view keeps the file and the mapping object alive by itself, so the handles can be closed right away
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (mapping) CloseHandle(mapping);
+	CloseHandle(file);
+	if (!view) {
+		throw std::runtime_error("Failed to map " + path.string() + "!");
+	}
+
+	data = static_cast<const uint8_t*>(view);
+	size = size_t(fileSize.QuadPart);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		throw std::runtime_error("Failed to open " + path.string() + " for mapping!");
+	}
+
+	struct stat info;
+	void* view = MAP_FAILED;
+	if (fstat(file, &info) == 0 && info.st_size > 0) {
+		view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+	}
+	close(file);
+	if (view == MAP_FAILED) {
+		throw std::runtime_error("Failed to map " + path.string() + "!");
+	}
+
+	data = static_cast<const uint8_t*>(view);
+	size = size_t(info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
\ No newline at end of file
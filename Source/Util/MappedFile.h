@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+//Read only view of a whole file in memory. Pages are only read from disk when they're first touched,
+//and are shared with the OS file cache instead of being copied out of it.
+//Writes made to the file through other handles show up in the view, so don't overwrite bytes that are still being read.
+class MappedFile {
+public:
+	MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const uint8_t* Data() const { return data; }
+	size_t Size() const { return size; }
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+};
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "MemoryTracker.h"
+
+#include <fstream>
+#include <sstream>
+
+MemoryTracker::Counters MemoryTracker::counters[size_t(MemoryCategory::Count)];
+
+void MemoryTracker::Add(MemoryCategory category, int64_t bytes, int64_t objects) {
+	Counters& entry = counters[size_t(category)];
+	entry.objects += objects;
+	UpdatePeak(entry, entry.bytes += bytes);
+}
+
+void MemoryTracker::Set(MemoryCategory category, int64_t bytes, int64_t objects) {
+	Counters& entry = counters[size_t(category)];
+	entry.objects = objects;
+	entry.bytes = bytes;
+	UpdatePeak(entry, bytes);
+}
+
+MemoryUsage MemoryTracker::Usage(MemoryCategory category) {
+	const Counters& entry = counters[size_t(category)];
+	return MemoryUsage{ entry.bytes, entry.objects, entry.peakBytes };
+}
+
+const char* MemoryTracker::Name(MemoryCategory category) {
+	switch (category) {
+	case MemoryCategory::ChunkData: return "ChunkData";
+	case MemoryCategory::ChunkMeshes: return "ChunkMeshes";
+	case MemoryCategory::StagingBuffers: return "StagingBuffers";
+	case MemoryCategory::Buffers: return "Buffers";
+	case MemoryCategory::Textures: return "Textures";
+	case MemoryCategory::DescriptorPools: return "DescriptorPools";
+	default: return "Unknown";
+	}
+}
+
+std::string MemoryTracker::ToJson() {
+	std::stringstream json;
+	int64_t totalBytes = 0;
+	json << "{\n\t\"categories\": {\n";
+	for (size_t i = 0; i < size_t(MemoryCategory::Count); i++) {
+		MemoryUsage usage = Usage(MemoryCategory(i));
+		totalBytes += usage.bytes;
+		json << "\t\t\"" << Name(MemoryCategory(i)) << "\": { \"bytes\": " << usage.bytes << ", \"objects\": " << usage.objects
+			<< ", \"peakBytes\": " << usage.peakBytes << " }" << (i + 1 < size_t(MemoryCategory::Count) ? ",\n" : "\n");
+	}
+	json << "\t},\n\t\"totalBytes\": " << totalBytes << "\n}\n";
+	return json.str();
+}
+
+bool MemoryTracker::WriteJson(const std::filesystem::path& path) {
+	std::ofstream file(path);
+	file << ToJson();
+	return bool(file);
+}
+
+void MemoryTracker::UpdatePeak(Counters& entry, int64_t bytes) {
+	int64_t peak = entry.peakBytes;
+	while (bytes > peak && !entry.peakBytes.compare_exchange_weak(peak, bytes)) {}
+}
\ No newline at end of file
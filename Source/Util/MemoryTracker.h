@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+enum class MemoryCategory {
+	ChunkData, //Block storage of the chunks in memory, sampled by ChunkManager
+	ChunkMeshes, //ChunkMesh objects and their vertex/index buffers. Only the meshes are counted as objects, the buffers just add their bytes
+	StagingBuffers, //Buffers only used as the source of a copy
+	Buffers, //Every other Buffer
+	Textures,
+	DescriptorPools, //Drivers don't say how big a pool is, so only the count is known
+	Count
+};
+
+struct MemoryUsage {
+	int64_t bytes = 0;
+	int64_t objects = 0;
+	int64_t peakBytes = 0;
+};
+
+//Live bytes and object counts per subsystem, so memory regressions between builds show up as numbers.
+//Subsystems Add and Remove their allocations as they make and free them, or Set totals they sample themselves.
+//Thread safe.
+class MemoryTracker {
+public:
+	static void Add(MemoryCategory category, int64_t bytes, int64_t objects = 1);
+	static void Remove(MemoryCategory category, int64_t bytes, int64_t objects = 1) { Add(category, -bytes, -objects); }
+	static void Set(MemoryCategory category, int64_t bytes, int64_t objects);
+
+	static MemoryUsage Usage(MemoryCategory category);
+	static const char* Name(MemoryCategory category);
+
+	static std::string ToJson();
+	//Returns false if the file couldn't be written
+	static bool WriteJson(const std::filesystem::path& path);
+
+private:
+	struct Counters {
+		std::atomic<int64_t> bytes = 0;
+		std::atomic<int64_t> objects = 0;
+		std::atomic<int64_t> peakBytes = 0;
+	};
+
+	static void UpdatePeak(Counters& entry, int64_t bytes);
+
+	static Counters counters[size_t(MemoryCategory::Count)];
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+//Counter-based random numbers for world generation. A number is a pure function of the world seed, a position,
+//an optional salt (so different features at the same spot don't get the same numbers) and its index in the stream,
+//with no hidden state: a column gets the same numbers whichever thread generates it, in whatever order.
+//It's SplitMix64 run in counter mode, the state is never carried over from one number to the next, only the counter
+class Random {
+public:
+	Random(uint64_t seed, int32_t x, int32_t z, uint32_t salt = 0) : key(Key(seed, x, z, salt)) {}
+
+	//The n-th number of the stream, doesn't move the counter
+	uint64_t At(uint64_t n) const { return Mix(key + (n + 1) * GOLDEN_GAMMA); }
+	uint64_t Next() { return At(counter++); }
+	//Between 0 and 1, not including 1
+	float NextFloat() { return float(Next() >> 40) * (1.f / float(1 << 24)); }
+	//Between 0 and bound, not including bound
+	uint32_t NextInt(uint32_t bound) { return uint32_t(((Next() >> 32) * bound) >> 32); }
+
+	uint64_t Counter() const { return counter; }
+
+	//The SplitMix64 finalizer, every bit of the input affects every bit of the output
+	static uint64_t Mix(uint64_t value) {
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+
+	static uint64_t Key(uint64_t seed, int32_t x, int32_t z, uint32_t salt = 0) {
+		uint64_t key = Mix(seed + GOLDEN_GAMMA);
+		key = Mix(key ^ ((uint64_t(uint32_t(x)) << 32) | uint32_t(z)));
+		return Mix(key ^ salt);
+	}
+
+private:
+	static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+	uint64_t key;
+	uint64_t counter = 0;
+};
\ No newline at end of file
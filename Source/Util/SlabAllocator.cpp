@@ -0,0 +1,174 @@
+#include "SlabAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+constexpr size_t SLAB_SIZE = 256 * 1024;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+constexpr size_t SIZE_CLASSES[] = { 512, 1024, 2048, 4096 };
+constexpr size_t NUM_SIZE_CLASSES = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+
+static std::atomic<bool> hugePages = false;
+static std::atomic<uint64_t> fallbacks = 0;
+
+//Huge page slabs have to be aligned to the huge page size, so map twice as much and trim the ends
+static void* AllocateSlab(size_t& size) {
+#ifdef __linux__
+	if (hugePages) {
+		size = HUGE_PAGE_SIZE;
+		void* mapping = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapping != MAP_FAILED) {
+			uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+			uintptr_t aligned = (start + size - 1) & ~(uintptr_t)(size - 1);
+			if (aligned > start) munmap(mapping, aligned - start);
+			if (aligned + size < start + 2 * size) munmap(reinterpret_cast<void*>(aligned + size), start + 2 * size - (aligned + size));
+			madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+#endif
+
+	size = SLAB_SIZE;
+	return ::operator new(size);
+}
+
+static void FreeSlab(void* slab, size_t size) {
+#ifdef __linux__
+	if (size == HUGE_PAGE_SIZE) {
+		munmap(slab, size);
+		return;
+	}
+#endif
+
+	::operator delete(slab);
+}
+
+SlabPool::SlabPool(size_t blockSize) : blockSize(blockSize) {
+
+}
+
+SlabPool::~SlabPool() {
+	for (const auto& [slab, size] : slabs) {
+		FreeSlab(slab, size);
+	}
+}
+
+void* SlabPool::Allocate() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.allocations++;
+	stats.usedBytes += blockSize;
+	stats.peakUsedBytes = std::max(stats.peakUsedBytes, stats.usedBytes);
+
+	if (freeList) {
+		FreeBlock* block = freeList;
+		freeList = block->next;
+		stats.recycled++;
+		return block;
+	}
+
+	if (next + blockSize > end) {
+		NewSlab();
+	}
+
+	void* block = next;
+	next += blockSize;
+	return block;
+}
+
+void SlabPool::Free(void* block) {
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.usedBytes -= blockSize;
+
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = freeList;
+	freeList = freeBlock;
+}
+
+SlabStats SlabPool::Stats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void SlabPool::ResetPeak() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.peakUsedBytes = stats.usedBytes;
+}
+
+void SlabPool::NewSlab() {
+	size_t size;
+	void* slab = AllocateSlab(size);
+	slabs.emplace_back(slab, size);
+	stats.reservedBytes += size;
+
+	next = static_cast<char*>(slab);
+	end = next + size;
+}
+
+void* SlabAllocator::Allocate(size_t bytes) {
+	if (SlabPool* pool = Pool(bytes)) {
+		return pool->Allocate();
+	}
+
+	fallbacks++;
+	return ::operator new(bytes);
+}
+
+void SlabAllocator::Free(void* ptr, size_t bytes) {
+	if (SlabPool* pool = Pool(bytes)) {
+		pool->Free(ptr);
+		return;
+	}
+
+	::operator delete(ptr);
+}
+
+void SlabAllocator::SetHugePages(bool enable) {
+	hugePages = enable;
+}
+
+bool SlabAllocator::HugePages() {
+	return hugePages;
+}
+
+SlabStats SlabAllocator::Stats() {
+	SlabStats total;
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+		SlabStats stats = Pool(SIZE_CLASSES[i])->Stats();
+		total.allocations += stats.allocations;
+		total.recycled += stats.recycled;
+		total.usedBytes += stats.usedBytes;
+		total.peakUsedBytes += stats.peakUsedBytes;
+		total.reservedBytes += stats.reservedBytes;
+	}
+
+	total.fallbacks = fallbacks;
+	total.allocations += total.fallbacks;
+	return total;
+}
+
+void SlabAllocator::ResetPeak() {
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+		Pool(SIZE_CLASSES[i])->ResetPeak();
+	}
+}
+
+SlabPool* SlabAllocator::Pool(size_t bytes) {
+	//Never destroyed, so storage freed during static destruction still has somewhere to go
+	static SlabPool* pools = [] {
+		SlabPool* pools = static_cast<SlabPool*>(::operator new(sizeof(SlabPool) * NUM_SIZE_CLASSES));
+		for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+			new (&pools[i]) SlabPool(SIZE_CLASSES[i]);
+		}
+		return pools;
+	}();
+
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+		if (bytes == SIZE_CLASSES[i]) return &pools[i];
+	}
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+struct SlabStats {
+	uint64_t allocations = 0;
+	//Allocations served from a block freed earlier rather than fresh slab memory
+	uint64_t recycled = 0;
+	//Allocations too big for any size class, passed on to operator new
+	uint64_t fallbacks = 0;
+	//Bytes handed out and not freed yet
+	size_t usedBytes = 0;
+	size_t peakUsedBytes = 0;
+	//Bytes of slab memory taken from the system. Slabs are kept for reuse, so this only grows
+	size_t reservedBytes = 0;
+
+	double HitRate() const { return allocations > 0 ? double(recycled) / double(allocations) : 0.0; }
+};
+
+//Blocks of one fixed size carved out of large slabs. Freed blocks go on a free list and are handed out
+//again before any new slab memory is touched, so allocation churn doesn't fragment the heap. Thread safe.
+class SlabPool {
+public:
+	SlabPool(size_t blockSize);
+	~SlabPool();
+
+	SlabPool(const SlabPool&) = delete;
+	SlabPool& operator=(const SlabPool&) = delete;
+
+	size_t BlockSize() const { return blockSize; }
+
+	void* Allocate();
+	void Free(void* block);
+
+	SlabStats Stats();
+	void ResetPeak();
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	void NewSlab();
+
+	size_t blockSize;
+	FreeBlock* freeList = nullptr;
+	char* next = nullptr; //Start of the untouched part of the newest slab
+	char* end = nullptr;
+	std::vector<std::pair<void*, size_t>> slabs;
+	SlabStats stats;
+	std::mutex mutex;
+};
+
+//Size classed slab pools for chunk block storage. Sizes line up with the packed index arrays of a section
+//at 1, 2, 4 and 8 bits per block, anything else goes to operator new.
+class SlabAllocator {
+public:
+	static void* Allocate(size_t bytes);
+	static void Free(void* ptr, size_t bytes);
+
+	//Back new slabs with transparent huge pages, fewer TLB misses when walking lots of sections.
+	//Only does anything on Linux, and only for slabs allocated after it's turned on
+	static void SetHugePages(bool enable);
+	static bool HugePages();
+
+	//Summed over every size class
+	static SlabStats Stats();
+	//Starts peakUsedBytes over from what's in use now, to measure the peak of one stretch of work
+	static void ResetPeak();
+
+private:
+	static SlabPool* Pool(size_t bytes);
+};
+
+//std::allocator replacement that goes through SlabAllocator
+template<typename T>
+class PoolAllocator {
+public:
+	using value_type = T;
+
+	PoolAllocator() = default;
+	template<typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(SlabAllocator::Allocate(n * sizeof(T))); }
+	void deallocate(T* ptr, size_t n) { SlabAllocator::Free(ptr, n * sizeof(T)); }
+
+	template<typename U> bool operator==(const PoolAllocator<U>&) const { return true; }
+	template<typename U> bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
\ No newline at end of file